@@ -0,0 +1,1477 @@
+#ifndef MATRIX_CPP_H
+#define MATRIX_CPP_H
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <variant>
+#include <vector>
+
+#include "matrix_exceptions.hpp"
+#include "matrix_iterator.hpp"
+#include "matrix_parallel.hpp"
+#include "matrix_service.hpp"
+#include "matrix_vector.hpp"
+
+/**
+ * @brief Enumeration to indicate addition or subtraction operations.
+ * @note Sum  ///< Represents addition.
+ * @note Sub  ///< Represents addition.
+ */
+enum class SumSub { Sum, Sub };
+
+/**
+ * @brief Enumeration to select the precision of the solvers.
+ * @note Double  ///< Double precision LU decomposition.
+ * @note Mixed  ///< Single precision LU decomposition refined with double
+ * precision residuals, falling back to Double when refinement stalls.
+ */
+enum class Precision { Double, Mixed };
+
+/**
+ * @brief Enumeration to select the reduction applied to a group of elements.
+ * @note NormOne, NormTwo and NormInf are the vector norms of the group (the
+ * sum of absolute values, the euclidean norm and the largest absolute value).
+ */
+enum class Reduction { Sum, Mean, Min, Max, NormOne, NormTwo, NormInf };
+
+/**
+ * @brief Enumeration to select a matrix norm.
+ * @note One  ///< Maximum absolute column sum.
+ * @note Infinity  ///< Maximum absolute row sum.
+ * @note Frobenius  ///< Square root of the sum of squared elements.
+ */
+enum class MatrixNorm { One, Infinity, Frobenius };
+
+/**
+ * @brief A class representing a matrix with various operations and utilities.
+ * @note Methods without "noexcept" keyword include verios of throws.
+ * @see matrix_exceptions.hpp
+ */
+class Matrix {
+ private:
+  int rows_{0}, cols_{0};  ///< Number of rows and columns in the matrix.
+  double** matrix_ =
+      nullptr;  ///< Pointer to the row table of the matrix (one per row).
+  double* data_ = nullptr;  ///< Contiguous block the row table points to.
+  int row_capacity_{0};     ///< Number of rows the storage can hold.
+  int stride_{0};  ///< Padded distance between rows (leading dimension).
+  mutable unsigned long version_{0};  ///< Bumped on every content mutation.
+  struct DerivedCache;
+  mutable DerivedCache* cache_ =
+      nullptr;  ///< Memoized derived results (null if caching is disabled).
+  /**
+   * @brief Ownership of an external buffer wrapped by the matrix.
+   */
+  struct ExternalStorage {
+    std::atomic<long> references{1};  ///< Matrices sharing the buffer.
+    std::function<void(double*)> deleter;  ///< Frees it (empty if borrowed).
+    bool read_only = false;  ///< Whether writes must copy it first.
+  };
+  ExternalStorage* external_ =
+      nullptr;  ///< Set if data_ is an external buffer (null otherwise).
+  alignas(MEMORY_ALIGNMENT) double inline_data_
+      [INLINE_ELEMENTS];  ///< Storage of small matrices (no allocation).
+  double* inline_rows_[INLINE_ELEMENTS];  ///< Row table of inline storage.
+
+  /**
+   * @brief Allocates zero initialized memory for the matrix based on its
+   * dimensions and capacity.
+   */
+  void allocateMatrix();
+  /**
+   * @brief Releases the storage of the matrix, freeing it if no other matrix
+   * shares it.
+   */
+  void freeMatrix() noexcept;
+  /**
+   * @brief Points the row table at the rows of the storage.
+   */
+  void linkRows() noexcept {
+    for (int i = 0; i < row_capacity_; ++i)
+      matrix_[i] = data_ + static_cast<std::size_t>(i) * stride_;
+  }
+  /**
+   * @brief Checks whether the matrix is stored inside the object.
+   * @return True for inline storage, which is copied rather than shared.
+   */
+  bool isInline() const noexcept { return data_ == inline_data_; }
+  /**
+   * @brief Retrieves the reference count kept in front of the storage (or in
+   * the control block of an external buffer).
+   * @note Inline storage has none.
+   * @return The number of matrices sharing the storage.
+   */
+  std::atomic<long>& references() const noexcept {
+    if (external_) return external_->references;
+    return *std::launder(
+        reinterpret_cast<std::atomic<long>*>(data_ - STORAGE_HEADER));
+  }
+  /**
+   * @brief Checks whether the storage is shared with other matrices.
+   * @return True if the storage has to be copied before a write.
+   */
+  bool isShared() const noexcept {
+    if (!data_ || isInline()) return false;
+    if (external_ && external_->read_only) return true;
+    return references().load(std::memory_order_acquire) > 1;
+  }
+  /**
+   * @brief Checks whether the storage can hold a shape without reallocation.
+   * @param rows Number of rows.
+   * @param columns Number of columns.
+   * @return True if the shape fits (an external buffer can not hold more
+   * columns than it was wrapped with, the rest of the stride is not its own).
+   */
+  bool fitsStorage(const int rows, const int columns) const noexcept {
+    return rows <= row_capacity_ && columns <= getColCapacity();
+  }
+  /**
+   * @brief Gives the matrix its own copy of a shared storage; every write to
+   * the elements goes through it first.
+   * @throws MemoryAllocationError if the copy can not be allocated.
+   */
+  void detach() {
+    // The stride of an external buffer belongs to the caller, so its copy
+    // only holds the matrix.
+    if (isShared() && external_)
+      reallocateMatrix(rows_, cols_);
+    else if (isShared())
+      reallocateMatrix(row_capacity_, stride_);
+  }
+  /**
+   * @brief Sets the matrix pointer to a null state and amount of rows and
+   * columns to zero.
+   */
+  void setNullMatrix() noexcept;
+  /**
+   * @brief Releases the storage of the matrix and shares the one of another
+   * matrix instead.
+   * @param other The matrix to share the storage of.
+   */
+  void shareMatrix(const Matrix& other) noexcept;
+  /**
+   * @brief Takes over the storage fields of another matrix, copying inline
+   * storage into the own one; the reference count is left to the caller.
+   * @param other The matrix to take the storage of.
+   */
+  void adoptStorage(const Matrix& other) noexcept;
+  /**
+   * @brief Makes an external buffer the storage of an empty matrix.
+   * @param data The first element of the buffer.
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param stride Distance between the starts of consecutive rows.
+   */
+  void wrapExternal(double* data, const int rows, const int cols,
+                    const int stride);
+  /**
+   * @brief Marks the content of the matrix as changed (bumps the version).
+   */
+  void touch() const noexcept { ++version_; }
+  /**
+   * @brief Locks the derived results cache, dropping stale results.
+   * @return The lock guarding cache_ (owning no mutex if caching is disabled).
+   * @note Results are computed without the lock, so a cached method never
+   * holds it while calling another one.
+   */
+  std::unique_lock<std::mutex> lockCache() const;
+  /**
+   * @brief Calculates the determinant by cofactor expansion (no caching).
+   * @return The determinant of the matrix.
+   */
+  double determinantCofactor() const;
+  /**
+   * @brief Moves the matrix into a new storage of the given capacity.
+   * @param row_capacity The number of rows the new storage can hold.
+   * @param stride The number of columns the new storage can hold.
+   */
+  void reallocateMatrix(const int row_capacity, const int stride);
+  /**
+   * @brief Performs addition or subtraction on matrices.
+   * @param other The matrix to be added or subtracted to the one this method
+   * was called from.
+   * @param mod Indicates whether to add or subtract.
+   * @return Resultant matrix after addition or subtraction.
+   */
+  Matrix matrixSumSub(const Matrix& other, SumSub mod) const;
+  /**
+   * @brief Creates a minor matrix by excluding a specific row and column.
+   * @param row The row to exclude.
+   * @param col The column to exclude.
+   * @return The minor matrix.
+   */
+  Matrix minorMaker(const int row, const int col) const;
+  /**
+   * @brief Inverts the matrix with Gauss-Jordan elimination and partial
+   * pivoting in O(n^3).
+   * @param det Output parameter for the determinant of the matrix.
+   * @return The inversed matrix or an empty one if the matrix is singular (det
+   * is set to zero then).
+   */
+  Matrix gaussJordanInverse(double& det) const;
+  /**
+   * @brief Calculates the 1-norm (maximum absolute column sum) of the matrix.
+   * @return The 1-norm of the matrix.
+   */
+  double normOne() const noexcept;
+  /**
+   * @brief Calculates the infinity norm (maximum absolute row sum) of the
+   * matrix.
+   * @return The infinity norm of the matrix.
+   */
+  double normInf() const noexcept;
+  /**
+   * @brief Validates every element of the matrix.
+   * @throws DataError if any element is NaN or infinite.
+   */
+  void validateData() const {
+    if (!dataLegit()) throw DataError();
+  }
+  /**
+   * @brief Checks, without throwing, that no element is NaN or infinite.
+   * @return True if every element is finite, false otherwise.
+   */
+  bool dataLegit() const noexcept;
+  /**
+   * @brief Checks that a set square matrix with finite elements is given.
+   * @return The error code of the first failed check.
+   */
+  MatrixStatus checkSquare() const noexcept;
+  /**
+   * @brief Checks the preconditions of addition and subtraction.
+   * @param other The second operand.
+   * @return The error code of the first failed check.
+   */
+  MatrixStatus checkSumSub(const Matrix& other) const noexcept;
+  /**
+   * @brief Checks the preconditions of matrix multiplication.
+   * @param other The right operand.
+   * @return The error code of the first failed check.
+   */
+  MatrixStatus checkMulMatrix(const Matrix& other) const noexcept;
+  /**
+   * @brief Solves A * X = B column by column with an LU decomposition.
+   * @param b The right hand side, element (i, j) at b[i * b_stride + j].
+   * @param b_stride The distance between rows of b.
+   * @param m The number of columns of b.
+   * @param x The solution, element (i, j) at x[i * x_stride + j].
+   * @param x_stride The distance between rows of x.
+   * @param precision The precision of the decomposition.
+   * @param max_refinements The limit of refinement steps (Mixed only).
+   * @note The matrix and b must be checked by the caller.
+   */
+  void solveInto(const double* b, const int b_stride, const int m, double* x,
+                 const int x_stride, const Precision precision,
+                 const int max_refinements) const;
+  /**
+   * @brief Checks the preconditions of the solvers.
+   * @param rhs_rows The number of rows of the right hand side.
+   * @param max_refinements The limit of refinement steps.
+   */
+  void checkSolve(const int rhs_rows, const int max_refinements) const;
+  /**
+   * @brief Calculates the inverse matrix from a known non-zero determinant.
+   * @param det The determinant of the matrix.
+   * @return The inversed matrix.
+   */
+  Matrix inverseFromDeterminant(const double det) const;
+  /**
+   * @brief Runs an operation after its preconditions were checked, turning
+   * any remaining exception (e.g. memory allocation) into an error code.
+   * @param status The result of the precondition checks.
+   * @param operation The operation to run when the checks passed.
+   * @return The error code of the operation.
+   */
+  template <typename Operation>
+  static MatrixStatus tryOperation(const MatrixStatus status,
+                                   Operation&& operation) noexcept {
+    if (status != MatrixStatus::Ok) return status;
+    try {
+      operation();
+    } catch (const MatrixError& error) {
+      return error.status();
+    } catch (...) {
+      return MatrixStatus::UnknownError;
+    }
+    return MatrixStatus::Ok;
+  }
+  /**
+   * @brief Multiplies op(a) by op(b), where op() optionally transposes.
+   * @details Every transposition combination (NN, NT, TN, TT) has its own loop
+   * order so that the original storage is always read row by row. Gram
+   * products (A^T * A, A * A^T) only compute the upper triangle.
+   * @param a The left matrix.
+   * @param a_trans Whether the left matrix is transposed.
+   * @param b The right matrix.
+   * @param b_trans Whether the right matrix is transposed.
+   * @return Resulting matrix.
+   */
+  static Matrix multiplyKernel(const Matrix& a, const bool a_trans,
+                               const Matrix& b, const bool b_trans);
+  /**
+   * @brief Multiplies op(a) by op(b) into an existing matrix, reusing its
+   * storage when it is large enough.
+   * @param a The left matrix.
+   * @param a_trans Whether the left matrix is transposed.
+   * @param b The right matrix.
+   * @param b_trans Whether the right matrix is transposed.
+   * @param result The matrix receiving the product (must not be a or b).
+   * @see multiplyKernel
+   */
+  static void multiplyInto(const Matrix& a, const bool a_trans,
+                           const Matrix& b, const bool b_trans,
+                           Matrix& result);
+  /**
+   * @brief Transforms the matrix in place into row echelon form by Gaussian
+   * elimination with partial pivoting.
+   * @param tolerance The pivot tolerance (negative selects the default).
+   * @param reduced Whether to produce the reduced form (unit pivots, zeros
+   * above them).
+   * @return The pivot column of every nonzero row (its size is the rank).
+   */
+  std::vector<int> eliminate(double tolerance, const bool reduced);
+  /**
+   * @brief Reduces every row without finishing the reduction (Mean gives the
+   * sum, NormTwo the sum of squares).
+   * @param kind The reduction.
+   * @return The row results.
+   */
+  std::vector<double> rowPartials(const Reduction kind) const;
+  /**
+   * @brief Runs a body for every row index, splitting the rows between
+   * threads when the matrix is large.
+   * @param body Callable invoked as body(row).
+   */
+  template <typename Body>
+  void forEachRow(Body&& body) const {
+    MatrixParallel::parallelFor(0, rows_, cols_, [&](int from, int to) {
+      for (int i = from; i < to; i++) body(i);
+    });
+  }
+  /**
+   * @brief Resizes the matrix to a zero matrix, keeping the storage when it
+   * has enough capacity and dropping the old content otherwise.
+   * @param rows The new number of rows.
+   * @param columns The new number of columns.
+   */
+  void reshapeZero(const int rows, const int columns);
+
+  /**
+   * @brief A helper class to represent an element of the matrix.
+   * @note This is used for index reference of matrix elements.
+   * @see MatrixElement operator()(const int row, const int col) const;
+   */
+  class MatrixElement {
+    double* ptr =
+        nullptr;  ///< Pointer to the address of element in the matrix.
+    const Matrix* owner = nullptr;  ///< The matrix the element belongs to.
+
+   public:
+    /**
+     * @brief Constructs a MatrixElement.
+     * @param matrix The matrix object.
+     * @param row Row index of the element.
+     * @param col Column index of the element.
+     */
+    MatrixElement(const Matrix& matrix, const int row,
+                  const int col) noexcept
+        : ptr{&(matrix.matrix_[row][col])}, owner{&matrix} {}
+    /**
+     * @brief Assigns a value to the matrix element.
+     * @param input The value to assign.
+     * @return The assigned value.
+     */
+    double operator=(const double input) {
+      if (!ptr) throw MatrixSetError();
+      MatrixService::doubleLegit(input);
+      if (owner->isShared()) {
+        // The copy may have another stride, so the position is kept as row
+        // and column.
+        const std::ptrdiff_t offset = ptr - owner->data_;
+        const int row = static_cast<int>(offset / owner->stride_);
+        const int col = static_cast<int>(offset % owner->stride_);
+        const_cast<Matrix*>(owner)->detach();
+        ptr = owner->matrix_[row] + col;
+      }
+      *ptr = input;
+      owner->touch();
+      return input;
+    }
+    /**
+     * @brief Implicit conversion to the element's value.
+     * @return The value of the matrix element.
+     */
+    operator double() const { return *ptr; }
+  };
+
+ public:
+  /**
+   * @brief A constant time transposed view of a matrix.
+   * @note Returned by Transpose(). Products with the view read the original
+   * storage; conversion to Matrix materializes the transposed copy.
+   * @warning The view refers to the original matrix and must not outlive it.
+   * @see Matrix Transpose() const;
+   */
+  class TransposedMatrix {
+    const Matrix* origin_ = nullptr;  ///< The matrix being viewed.
+
+   public:
+    /**
+     * @brief Constructs a transposed view.
+     * @param origin The matrix to view.
+     */
+    explicit TransposedMatrix(const Matrix& origin) noexcept
+        : origin_{&origin} {}
+    /**
+     * @brief Retrieves the number of rows of the transposed matrix.
+     * @return Number of rows.
+     */
+    int getRows() const noexcept { return origin_->cols_; }
+    /**
+     * @brief Retrieves the number of columns of the transposed matrix.
+     * @return Number of columns.
+     */
+    int getCols() const noexcept { return origin_->rows_; }
+    /**
+     * @brief Retrieves the value of a specific element of the transposed
+     * matrix.
+     * @param row Row index of the element.
+     * @param col Column index of the element.
+     * @return The value of the element.
+     */
+    double getElement(const int row, const int col) const {
+      return origin_->getElement(col, row);
+    }
+    /**
+     * @brief Retrieves the matrix the view refers to.
+     * @return Reference to the original (not transposed) matrix.
+     */
+    const Matrix& getOrigin() const noexcept { return *origin_; }
+    /**
+     * @brief Materializes the transposed matrix (cache blocked copy).
+     * @return The transposed matrix.
+     */
+    operator Matrix() const;
+    /**
+     * @brief Multiplies the transposed matrix by a matrix (TN kernel).
+     * @param other The matrix to multiply by.
+     * @return Resulting matrix.
+     */
+    Matrix operator*(const Matrix& other) const {
+      return multiplyKernel(*origin_, true, other, false);
+    }
+    /**
+     * @brief Multiplies the transposed matrix by a transposed matrix (TT
+     * kernel).
+     * @param other The transposed matrix to multiply by.
+     * @return Resulting matrix.
+     */
+    Matrix operator*(const TransposedMatrix& other) const {
+      return multiplyKernel(*origin_, true, *other.origin_, true);
+    }
+    /**
+     * @brief Multiplies the transposed matrix by a number.
+     * @param num The number to multiply by.
+     * @return Resulting matrix.
+     */
+    Matrix operator*(const double num) const { return Matrix(*this) * num; }
+    /**
+     * @brief Multiplies the transposed matrix by a vector (transposed GEMV).
+     * @param x The vector to multiply by.
+     * @return Resulting vector.
+     */
+    Vector operator*(const Vector& x) const {
+      Vector y(getRows());
+      origin_->GemvTransposed(1, x, 0, y);
+      return y;
+    }
+  };
+
+  /**
+   * @brief Default constructor.
+   */
+  Matrix() noexcept : rows_(0), cols_(0), matrix_(nullptr) {}
+  /**
+   * @brief Parametrized constructor with dimensions.
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   */
+  Matrix(const int rows, const int cols);
+  /**
+   * @brief Parametrized constructor with dimensions and values passed as array.
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param n Number of elements in the array.
+   * @param arr Array of values to initialize the matrix.
+   */
+  Matrix(const int rows, const int cols, const int n, const double arr[])
+      : Matrix(rows, cols) {
+    setMatrix(n, arr);
+  }
+  /**
+   * @brief Wraps an external row major buffer without copying or validating
+   * it.
+   * @details Without a deleter the buffer is borrowed: it must outlive the
+   * matrix and its copies, and writes go to it directly. With a deleter the
+   * buffer is adopted and passed to the deleter (which must not throw) when
+   * the last matrix sharing it releases it. Either way a write to a buffer
+   * shared by several matrices, or growing the matrix past its shape, copies
+   * it into own storage first.
+   * @param data The first element of the buffer.
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param stride Distance between the starts of consecutive rows (at least
+   * cols).
+   * @param deleter Frees an adopted buffer.
+   * @throws DimentionError if rows or cols is not positive, InputError if
+   * data is null or stride is less than cols (the buffer is left to the
+   * caller then).
+   */
+  Matrix(double* data, const int rows, const int cols, const int stride,
+         std::function<void(double*)> deleter = nullptr);
+  /**
+   * @brief Borrows a read only external buffer; the first write copies it
+   * into own storage.
+   * @param data The first element of the buffer.
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param stride Distance between the starts of consecutive rows (at least
+   * cols).
+   * @throws DimentionError if rows or cols is not positive, InputError if
+   * data is null or stride is less than cols.
+   */
+  Matrix(const double* data, const int rows, const int cols, const int stride);
+  /**
+   * @brief Copy constructor.
+   * @details The copy shares the storage of other, which is duplicated by the
+   * first write to either matrix (copy on write).
+   * @param other The matrix to copy.
+   */
+  Matrix(const Matrix& other) noexcept;
+  /**
+   * @brief Move constructor.
+   * @param other The matrix to move.
+   */
+  Matrix(Matrix&& other) noexcept
+      : version_(other.version_), cache_(other.cache_) {
+    adoptStorage(other);
+    other.setNullMatrix();
+    other.cache_ = nullptr;
+  }
+  /**
+   * @brief Destructor.
+   */
+  ~Matrix() noexcept;
+
+  // Getters and setters
+  /**
+   * @brief Retrieves the number of rows in the matrix.
+   * @return Number of rows.
+   */
+  int getRows() const noexcept { return rows_; }
+  /**
+   * @brief Retrieves the number of columns in the matrix.
+   * @return Number of columns.
+   */
+  int getCols() const noexcept { return cols_; }
+  /**
+   * @brief Retrieves the matrix dimensions.
+   * @param rows Output parameter for rows.
+   * @param columns Output parameter for columns.
+   */
+  void getDimentions(int& rows, int& columns) const noexcept {
+    rows = rows_;
+    columns = cols_;
+  }
+  /**
+   * @brief Retrieves the number of rows the matrix can hold without
+   * reallocation.
+   * @return Row capacity.
+   */
+  int getRowCapacity() const noexcept { return row_capacity_; }
+  /**
+   * @brief Retrieves the number of columns the matrix can hold without
+   * reallocation.
+   * @return Column capacity (the stride, or the columns of a wrapped external
+   * buffer whose stride belongs to the caller).
+   */
+  int getColCapacity() const noexcept { return external_ ? cols_ : stride_; }
+  /**
+   * @brief Retrieves the distance between the starts of consecutive rows
+   * (leading dimension).
+   * @note Rows start on MEMORY_ALIGNMENT boundaries once they are longer than
+   * half a cache line (unless the matrix wraps an external buffer).
+   * @return The stride in elements.
+   */
+  int getStride() const noexcept { return stride_; }
+  /**
+   * @brief Retrieves the storage of the matrix: element (i, j) is located at
+   * getData()[i * getStride() + j].
+   * @return Constant pointer to the aligned storage (nullptr if not set).
+   */
+  const double* getData() const noexcept { return data_; }
+
+  // Unchecked access
+  // The methods below perform no bounds, null or value checks. Mutable access
+  // bumps the version when the pointer or iterator is handed out, so cached
+  // results computed before then are dropped; keep writes through it ahead of
+  // the next Determinant() or InverseMatrix() call. It also copies a storage
+  // shared with other matrices (which may throw MemoryAllocationError), so
+  // pointers taken before a copy of the matrix is made still write to both.
+  using iterator = ElementIterator<double>;
+  using const_iterator = ElementIterator<const double>;
+  using Row = ElementRange<double*>;
+  using ConstRow = ElementRange<const double*>;
+  using Column = ElementRange<StridedIterator<double>>;
+  using ConstColumn = ElementRange<StridedIterator<const double>>;
+  using Span = MatrixSpan<double>;
+  using ConstSpan = MatrixSpan<const double>;
+  /**
+   * @brief Retrieves the mutable storage of the matrix: element (i, j) is
+   * located at data()[i * getStride() + j].
+   * @return Pointer to the aligned storage (nullptr if not set).
+   */
+  double* data() {
+    detach();
+    touch();
+    return data_;
+  }
+  /**
+   * @brief Retrieves the storage of the matrix.
+   * @return Constant pointer to the aligned storage (nullptr if not set).
+   */
+  const double* data() const noexcept { return data_; }
+  /**
+   * @brief Retrieves a mutable view of the storage with its shape and stride.
+   * @return The view (empty if the matrix is not set).
+   */
+  Span span() {
+    detach();
+    touch();
+    return Span(data_, rows_, cols_, stride_);
+  }
+  /**
+   * @brief Retrieves a view of the storage with its shape and stride.
+   * @return The view (empty if the matrix is not set).
+   */
+  ConstSpan span() const noexcept {
+    return ConstSpan(data_, rows_, cols_, stride_);
+  }
+  /**
+   * @brief Retrieves a row pointer, so that m[i][j] accesses element (i, j).
+   * @param row Row index.
+   * @return Pointer to the first element of the row.
+   */
+  double* operator[](const int row) {
+    detach();
+    touch();
+    return matrix_[row];
+  }
+  /**
+   * @brief Retrieves a constant row pointer.
+   * @param row Row index.
+   * @return Constant pointer to the first element of the row.
+   */
+  const double* operator[](const int row) const noexcept {
+    return matrix_[row];
+  }
+  /**
+   * @brief Retrieves an iterator to the first element (in row major order).
+   * @return The iterator.
+   */
+  iterator begin() {
+    detach();
+    touch();
+    return iterator(data_, 0, cols_, stride_);
+  }
+  /**
+   * @brief Retrieves an iterator past the last element.
+   * @return The iterator.
+   */
+  iterator end() {
+    detach();
+    return iterator(data_ + static_cast<std::ptrdiff_t>(rows_) * stride_, 0,
+                    cols_, stride_);
+  }
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator end() const noexcept { return cend(); }
+  /**
+   * @brief Retrieves a constant iterator to the first element.
+   * @return The iterator.
+   */
+  const_iterator cbegin() const noexcept {
+    return const_iterator(data_, 0, cols_, stride_);
+  }
+  /**
+   * @brief Retrieves a constant iterator past the last element.
+   * @return The iterator.
+   */
+  const_iterator cend() const noexcept {
+    return const_iterator(data_ + static_cast<std::ptrdiff_t>(rows_) * stride_,
+                          0, cols_, stride_);
+  }
+  /**
+   * @brief Retrieves the elements of a row.
+   * @param index Row index.
+   * @return Contiguous range of the row.
+   */
+  Row row(const int index) {
+    double* first = (*this)[index];
+    return Row(first, first + cols_);
+  }
+  /**
+   * @brief Retrieves the constant elements of a row.
+   * @param index Row index.
+   * @return Contiguous range of the row.
+   */
+  ConstRow row(const int index) const noexcept {
+    const double* first = (*this)[index];
+    return ConstRow(first, first + cols_);
+  }
+  /**
+   * @brief Retrieves the elements of a column.
+   * @param index Column index.
+   * @return Strided range of the column.
+   */
+  Column column(const int index) {
+    detach();
+    touch();
+    StridedIterator<double> first(data_ + index, stride_);
+    return Column(first, first + rows_);
+  }
+  /**
+   * @brief Retrieves the constant elements of a column.
+   * @param index Column index.
+   * @return Strided range of the column.
+   */
+  ConstColumn column(const int index) const noexcept {
+    StridedIterator<const double> first(data_ + index, stride_);
+    return ConstColumn(first, first + rows_);
+  }
+  /**
+   * @brief Retrieves the mutation version of the matrix.
+   * @note The version is bumped by every method changing the content
+   * (setters, element assignment, assignment and compound operators).
+   * @return The version counter.
+   */
+  unsigned long getVersion() const noexcept { return version_; }
+  /**
+   * @brief Calculates a hash of the dimensions and the exact bit content of the
+   * matrix.
+   * @note Four independent lanes are mixed so that the loop vectorizes. Equal
+   * matrices by EqMatrix (within EPSILON) may have different hashes.
+   * @return The hash (zero for an unset matrix).
+   */
+  std::size_t getHash() const noexcept;
+  /**
+   * @brief Checks whether derived results are cached.
+   * @return True if caching is enabled, false otherwise.
+   */
+  bool getCaching() const noexcept { return cache_ != nullptr; }
+  /**
+   * @brief Enables or disables memoization of derived results (determinant
+   * and inverse) until the next mutation of the matrix.
+   * @param enabled Whether caching is enabled.
+   * @note The setting belongs to the object: copies start without a cache,
+   * moves take it over. Determinant() and InverseMatrix() may be called
+   * concurrently on a cached matrix.
+   */
+  void setCaching(const bool enabled);
+  /**
+   * @brief Retrieves the matrix as a constant pointer.
+   * @return Constant pointer to the matrix.
+   */
+  const double** getMatrix() const noexcept {
+    return const_cast<const double**>(matrix_);
+  }
+  /**
+   * @brief Retrieves the value of a specific matrix element.
+   * @param row Row index of the element.
+   * @param col Column index of the element.
+   * @return The value of the element.
+   */
+  double getElement(const int row, const int col) const {
+    if (row >= rows_ || col >= cols_ || row < 0 || col < 0)
+      throw OutOfRangeError();
+    return matrix_[row][col];
+  }
+  /**
+   * @brief Converts the matrix to a one-dimensional array.
+   * @return A unique pointer to the resulting array.
+   */
+  std::unique_ptr<double[]> getArrayFromMatrix() const;
+
+  /**
+   * @brief Sets the value of a specific element in the matrix.
+   * @param row Row index of the element.
+   * @param col Column index of the element.
+   * @param value The value to assign.
+   */
+  void setElement(const int row, const int col, const double value) {
+    throwMatrixStatus(trySetElement(row, col, value));
+  }
+  /**
+   * @brief Sets the matrix values from a one-dimensional array.
+   * @param n The number of elements in the array.
+   * @param array The array of values.
+   */
+  void setMatrix(const int n, const double array[]) {
+    throwMatrixStatus(trySetMatrix(n, array));
+  }
+  /**
+   * @brief Sets the number of rows in the matrix.
+   * @param rows The new number of rows.
+   */
+  void setRows(const int rows) { setDimentions(rows, cols_); }
+  /**
+   * @brief Sets the number of columns in the matrix.
+   * @param cols The new number of columns.
+   */
+  void setCols(const int cols) { setDimentions(rows_, cols); }
+  /**
+   * @brief Sets new dimensions to the matrix.
+   * @param rows The number of rows.
+   * @param columns The number of columns.
+   * @note New elements are zero filled, the excess is discarded. Resizing
+   * within the capacity does not reallocate or copy.
+   */
+  void setDimentions(const int rows, const int columns);
+  /**
+   * @brief Reserves storage for at least the given amount of rows and
+   * columns.
+   * @param rows The number of rows to reserve.
+   * @param columns The number of columns to reserve.
+   * @note Never shrinks the capacity; for an unset matrix the capacity is
+   * applied by the first appendRow() or setDimentions().
+   */
+  void reserve(const int rows, const int columns);
+  /**
+   * @brief Appends a row to the end of the matrix.
+   * @param n The number of elements in the array (the rest is zero filled).
+   * @param row The array of values.
+   * @note The row capacity grows geometrically, so appending is amortized
+   * O(cols). An unset matrix becomes a 1 x n matrix.
+   */
+  void appendRow(const int n, const double row[]);
+  /**
+   * @brief Releases the unused capacity of the matrix.
+   */
+  void shrink_to_fit();
+  /**
+   * @brief Sets both the dimensions and values of the matrix.
+   * @param r The number of rows.
+   * @param c The number of columns.
+   * @param n The number of elements in the array.
+   * @param ar The array of values.
+   */
+  void setFull(const int r, const int c, const int n, const double ar[]) {
+    setDimentions(r, c);
+    setMatrix(n, ar);
+  }
+
+  // service methods
+  /**
+   * @brief Checks if the dimensions of the current matrix match another matrix.
+   * @param other The matrix to compare with.
+   * @return True if the dimensions match, false otherwise.
+   */
+  bool matrixDimentionEq(const Matrix& other) const;
+  /**
+   * @brief Prints the matrix to the console.
+   */
+  void print_matrix() const noexcept;
+  /**
+   * @brief Replaces the current matrix with another matrix.
+   * @param other The matrix to replace with.
+   */
+  void replaceMatrix(Matrix& other) noexcept;
+
+  // methods
+  /**
+   * @brief Checks matrices for equality.
+   * @param other The matrix to compare with.
+   * @return True if the matrices are equal, false otherwise.
+   */
+  bool EqMatrix(const Matrix& other) const;
+  /**
+   * @brief Adds another matrix to the current one.
+   * @param other The matrix to add.
+   */
+  void SumMatrix(const Matrix& other) {
+    Matrix res(*this + other);
+    this->replaceMatrix(res);
+  }
+  /**
+   * @brief Subtracts another matrix from the current one.
+   * @param other The matrix to subtract.
+   */
+  void SubMatrix(const Matrix& other) {
+    Matrix res(*this - other);
+    this->replaceMatrix(res);
+  }
+  /**
+   * @brief Multiplies the current matrix by a scalar value.
+   * @param num The scalar value to multiply with.
+   */
+  void MulNumber(const double num) {
+    Matrix res((*this) * num);
+    this->replaceMatrix(res);
+  }
+  /**
+   * @brief Multiplies the current matrix by another matrix.
+   * @param other The matrix to multiply with.
+   */
+  void MulMatrix(const Matrix& other) {
+    Matrix res((*this) * other);
+    this->replaceMatrix(res);
+  }
+  /**
+   * @brief Applies a function to every element.
+   * @details The rows are processed over the contiguous storage with the
+   * function inlined into the loop, so simple functions vectorize, and large
+   * matrices are split between threads.
+   * @param function Callable invoked as function(element), possibly from
+   * several threads at once.
+   * @return The matrix of the results.
+   * @throws DataError if a result is NaN or infinite.
+   */
+  template <typename Function>
+  Matrix Map(Function&& function) const {
+    if (!matrix_) throw MatrixSetError();
+    Matrix result(rows_, cols_);
+    forEachRow([&](const int i) {
+      const double* in = matrix_[i];
+      double* out = result.matrix_[i];
+      for (int j = 0; j < cols_; j++) out[j] = function(in[j]);
+    });
+    result.validateData();
+    return result;
+  }
+  /**
+   * @brief Replaces every element with the result of a function.
+   * @param function Callable invoked as function(element), possibly from
+   * several threads at once.
+   * @throws DataError if a result is NaN or infinite (the matrix keeps the
+   * results).
+   * @see Map
+   */
+  template <typename Function>
+  void MapInPlace(Function&& function) {
+    if (!matrix_) throw MatrixSetError();
+    detach();
+    forEachRow([&](const int i) {
+      double* row = matrix_[i];
+      for (int j = 0; j < cols_; j++) row[j] = function(row[j]);
+    });
+    touch();
+    validateData();
+  }
+  /**
+   * @brief Combines the elements of two matrices of the same dimensions.
+   * @param a The first matrix.
+   * @param b The second matrix.
+   * @param function Callable invoked as function(a_element, b_element),
+   * possibly from several threads at once.
+   * @return The matrix of the results.
+   * @throws DataError if a result is NaN or infinite.
+   * @see Map
+   */
+  template <typename Function>
+  static Matrix Zip(const Matrix& a, const Matrix& b, Function&& function) {
+    if (!a.matrix_ || !b.matrix_) throw MatrixSetError();
+    if (!a.matrixDimentionEq(b)) throw DimentionEqualityError();
+    Matrix result(a.rows_, a.cols_);
+    a.forEachRow([&](const int i) {
+      const double *in_a = a.matrix_[i], *in_b = b.matrix_[i];
+      double* out = result.matrix_[i];
+      for (int j = 0; j < a.cols_; j++) out[j] = function(in_a[j], in_b[j]);
+    });
+    result.validateData();
+    return result;
+  }
+  /**
+   * @brief Replaces every element with a function of it and the matching
+   * element of another matrix.
+   * @param other The matrix of the second arguments (may be this matrix).
+   * @param function Callable invoked as function(element, other_element),
+   * possibly from several threads at once.
+   * @throws DataError if a result is NaN or infinite (the matrix keeps the
+   * results).
+   * @see Zip
+   */
+  template <typename Function>
+  void ZipInPlace(const Matrix& other, Function&& function) {
+    if (!matrix_ || !other.matrix_) throw MatrixSetError();
+    if (!matrixDimentionEq(other)) throw DimentionEqualityError();
+    detach();
+    forEachRow([&](const int i) {
+      double* row = matrix_[i];
+      const double* in = other.matrix_[i];
+      for (int j = 0; j < cols_; j++) row[j] = function(row[j], in[j]);
+    });
+    touch();
+    validateData();
+  }
+  /**
+   * @brief Multiplies the matrices element by element (Hadamard product).
+   * @param other The matrix to multiply by.
+   * @return The element-wise product.
+   */
+  Matrix HadamardProduct(const Matrix& other) const;
+  /**
+   * @brief Divides the matrices element by element.
+   * @param other The matrix to divide by.
+   * @return The element-wise quotient.
+   * @throws DataError if an element of other is zero.
+   */
+  Matrix HadamardDivision(const Matrix& other) const;
+  /**
+   * @brief Limits every element to a range.
+   * @param low The lower bound.
+   * @param high The upper bound.
+   * @return The clamped matrix.
+   * @throws InputError if low is greater than high.
+   */
+  Matrix Clamp(const double low, const double high) const;
+  /**
+   * @brief Calculates the exponent of every element.
+   * @return The matrix of exponents.
+   * @throws DataError if a result overflows.
+   */
+  Matrix Exp() const;
+  /**
+   * @brief Calculates the natural logarithm of every element.
+   * @return The matrix of logarithms.
+   * @throws DataError if an element is not positive.
+   */
+  Matrix Log() const;
+  /**
+   * @brief Calculates the hyperbolic tangent of every element.
+   * @return The matrix of hyperbolic tangents.
+   */
+  Matrix Tanh() const;
+  /**
+   * @brief Reduces all the elements of the matrix to one value.
+   * @details Every row is reduced with several independent accumulators so
+   * that the loop vectorizes, rows are split between threads for large
+   * matrices and the row results are combined in row order.
+   * @param kind The reduction.
+   * @return The result.
+   * @throws DataError if the result is NaN or infinite.
+   */
+  double Reduce(const Reduction kind) const;
+  /**
+   * @brief Reduces every row of the matrix.
+   * @param kind The reduction.
+   * @return Vector of the row results.
+   * @throws DataError if a result is NaN or infinite.
+   */
+  Vector ReduceRows(const Reduction kind) const;
+  /**
+   * @brief Reduces every column of the matrix.
+   * @details The rows are walked in storage order while a block of columns
+   * is accumulated, blocks of columns are split between threads.
+   * @param kind The reduction.
+   * @return Vector of the column results.
+   * @throws DataError if a result is NaN or infinite.
+   */
+  Vector ReduceCols(const Reduction kind) const;
+  /**
+   * @brief Calculates the sum of all elements.
+   * @return The sum.
+   */
+  double Sum() const { return Reduce(Reduction::Sum); }
+  /**
+   * @brief Calculates the mean of all elements.
+   * @return The mean.
+   */
+  double Mean() const { return Reduce(Reduction::Mean); }
+  /**
+   * @brief Finds the smallest element.
+   * @return The smallest element.
+   */
+  double Min() const { return Reduce(Reduction::Min); }
+  /**
+   * @brief Finds the largest element.
+   * @return The largest element.
+   */
+  double Max() const { return Reduce(Reduction::Max); }
+  /**
+   * @brief Finds the position of the largest element (the first one in row
+   * major order if there are several).
+   * @param row Output parameter for the row index.
+   * @param col Output parameter for the column index.
+   */
+  void ArgMax(int& row, int& col) const;
+  /**
+   * @brief Finds the column of the largest element of every row.
+   * @return The column indices.
+   */
+  std::vector<int> ArgMaxRows() const;
+  /**
+   * @brief Finds the row of the largest element of every column.
+   * @return The row indices.
+   */
+  std::vector<int> ArgMaxCols() const;
+  /**
+   * @brief Calculates a matrix norm.
+   * @param kind The norm.
+   * @return The norm.
+   */
+  double Norm(const MatrixNorm kind = MatrixNorm::Frobenius) const;
+  /**
+   * @brief Calculates the sum of the diagonal elements.
+   * @return The trace.
+   * @throws SquarenessError if the matrix is not square.
+   */
+  double Trace() const;
+  /**
+   * @brief Calculates the sum of the products of matching elements
+   * (Frobenius inner product).
+   * @param other The matrix to multiply by.
+   * @return The inner product.
+   */
+  double Dot(const Matrix& other) const;
+  /**
+   * @brief Multiplies a chain of matrices in the cheapest order.
+   * @details The parenthesization minimizing the number of scalar
+   * multiplications is found by dynamic programming, then the products are
+   * evaluated in that order, reusing the storage of intermediate results.
+   * @param chain The matrices to multiply, from left to right.
+   * @return The product of the chain.
+   */
+  static Matrix MultiplyChain(
+      const std::vector<std::reference_wrapper<const Matrix>>& chain);
+  /**
+   * @brief Transposes the current matrix in constant time.
+   * @return The transposed view of the matrix (converts to Matrix).
+   * @see TransposedMatrix
+   */
+  TransposedMatrix Transpose() const;
+  /**
+   * @brief Creates a matrix of complements.
+   * @return The matrix of complements.
+   */
+  Matrix CalcComplements() const;
+  /**
+   * @brief Calculates the determinant of the matrix.
+   * @details Matrices up to COFACTOR_ORDER are expanded by cofactors, larger
+   * ones use the LU decomposition.
+   * @return The determinant of the matrix.
+   */
+  double Determinant() const;
+  /**
+   * @brief Creates an inversed matrix.
+   * @details Matrices up to COFACTOR_ORDER are inverted from their cofactors,
+   * larger ones with the LU decomposition.
+   * @return The inversed matrix.
+   */
+  Matrix InverseMatrix() const;
+  /**
+   * @brief Creates an inversed matrix with an O(n^3) LU decomposition.
+   * @param precision Precision::Mixed factorizes in float and refines every
+   * column with double residuals (falling back to Precision::Double when
+   * refinement stalls).
+   * @param max_refinements The limit of refinement steps per column.
+   * @return The inversed matrix.
+   */
+  Matrix InverseMatrix(const Precision precision,
+                       const int max_refinements = MAX_REFINEMENTS) const;
+  /**
+   * @brief Raises the matrix to an integer power by repeated squaring.
+   * @details O(n^3 log|power|) with two scratch buffers reused between the
+   * squarings. Negative powers raise the LU based inverse.
+   * @param power The exponent (0 gives the identity matrix).
+   * @return The matrix power.
+   */
+  Matrix Pow(const long power) const;
+  /**
+   * @brief Calculates the numerical rank by Gaussian elimination with partial
+   * pivoting in O(rows * cols * min(rows, cols)).
+   * @param tolerance Pivots with an absolute value not above it count as zero;
+   * a negative value selects max(rows, cols) * machine epsilon * the largest
+   * absolute element.
+   * @return The rank.
+   */
+  int Rank(const double tolerance = -1) const;
+  /**
+   * @brief Calculates the reduced row echelon form by Gauss-Jordan
+   * elimination with partial pivoting.
+   * @param tolerance The pivot tolerance (see Rank).
+   * @return The reduced row echelon form, with exact zeros below the
+   * tolerance.
+   */
+  Matrix RREF(const double tolerance = -1) const;
+  /**
+   * @brief Calculates a basis of the null space (the solutions of A * x = 0)
+   * from the reduced row echelon form.
+   * @param tolerance The pivot tolerance (see Rank).
+   * @return Matrix whose columns are the basis vectors (cols x nullity), or
+   * an empty matrix if the null space is trivial.
+   */
+  Matrix NullSpace(const double tolerance = -1) const;
+  /**
+   * @brief Solves the system A * X = B.
+   * @param b The right hand side matrix (rows equal the order of A).
+   * @param precision The precision of the LU decomposition.
+   * @param max_refinements The limit of refinement steps per column (Mixed
+   * only).
+   * @return The solution matrix X.
+   */
+  Matrix Solve(const Matrix& b, const Precision precision = Precision::Double,
+               const int max_refinements = MAX_REFINEMENTS) const;
+  /**
+   * @brief Solves the system A * x = b.
+   * @param b The right hand side vector (size equals the order of A).
+   * @param precision The precision of the LU decomposition.
+   * @param max_refinements The limit of refinement steps (Mixed only).
+   * @return The solution vector x.
+   */
+  Vector Solve(const Vector& b, const Precision precision = Precision::Double,
+               const int max_refinements = MAX_REFINEMENTS) const;
+  /**
+   * @brief Applies the low-rank update A + U * V^T to the current matrix and
+   * refreshes its inverse and determinant (Sherman-Morrison-Woodbury) in
+   * O(n^2 k).
+   * @param u The n x k left update matrix.
+   * @param v The n x k right update matrix.
+   * @param inverse The inverse of the current matrix, updated in place.
+   * @param det The determinant of the current matrix, updated in place.
+   * @note Falls back to a full O(n^3) recomputation when the k x k capacitance
+   * matrix is ill-conditioned (see UPDATE_RCOND_LIMIT).
+   */
+  void LowRankUpdate(const Matrix& u, const Matrix& v, Matrix& inverse,
+                     double& det);
+  /**
+   * @brief Matrix-vector product y = alpha * A * x + beta * y (GEMV).
+   * @param alpha The scale of the product.
+   * @param x The vector to multiply by (size equals the number of columns).
+   * @param beta The scale of y (y is not read when beta is zero).
+   * @param y The output vector (size equals the number of rows).
+   * @note Does not allocate; runs in parallel for large matrices.
+   * @throws DataError if the result is NaN or infinite (then y is
+   * unspecified).
+   */
+  void Gemv(const double alpha, const Vector& x, const double beta,
+            Vector& y) const;
+  /**
+   * @brief Transposed matrix-vector product y = alpha * A^T * x + beta * y.
+   * @param alpha The scale of the product.
+   * @param x The vector to multiply by (size equals the number of rows).
+   * @param beta The scale of y (y is not read when beta is zero).
+   * @param y The output vector (size equals the number of columns).
+   * @note Does not allocate; runs in parallel for large matrices.
+   * @throws DataError if the result is NaN or infinite (then y is
+   * unspecified).
+   */
+  void GemvTransposed(const double alpha, const Vector& x, const double beta,
+                      Vector& y) const;
+
+  // non-throwing variants
+  /**
+   * @brief Sets the value of a specific element without throwing.
+   * @param row Row index of the element.
+   * @param col Column index of the element.
+   * @param value The value to assign.
+   * @return The error code (the element is unchanged on error).
+   * @see setElement
+   */
+  MatrixStatus trySetElement(const int row, const int col,
+                             const double value) noexcept {
+    if (row >= rows_ || col >= cols_ || row < 0 || col < 0)
+      return MatrixStatus::OutOfRangeError;
+    if (!matrix_) return MatrixStatus::MatrixSetError;
+    if (!MatrixService::doubleIsLegit(value)) return MatrixStatus::DataError;
+    const MatrixStatus status =
+        tryOperation(MatrixStatus::Ok, [this] { detach(); });
+    if (status != MatrixStatus::Ok) return status;
+    matrix_[row][col] = value;
+    touch();
+    return MatrixStatus::Ok;
+  }
+  /**
+   * @brief Sets the matrix values from an array without throwing.
+   * @param n The number of elements in the array.
+   * @param array The array of values.
+   * @return The error code (the matrix is unchanged on error).
+   * @see setMatrix
+   */
+  MatrixStatus trySetMatrix(const int n, const double array[]) noexcept;
+  /**
+   * @brief Sets new dimensions to the matrix without throwing.
+   * @param rows The number of rows.
+   * @param columns The number of columns.
+   * @return The error code (the matrix is unchanged on error).
+   * @see setDimentions
+   */
+  MatrixStatus trySetDimentions(const int rows, const int columns) noexcept;
+  /**
+   * @brief Adds another matrix to the current one without throwing.
+   * @param other The matrix to add.
+   * @return The error code (the matrix is unchanged on error).
+   * @see SumMatrix
+   */
+  MatrixStatus TrySumMatrix(const Matrix& other) noexcept {
+    return tryOperation(checkSumSub(other), [&] { SumMatrix(other); });
+  }
+  /**
+   * @brief Subtracts another matrix from the current one without throwing.
+   * @param other The matrix to subtract.
+   * @return The error code (the matrix is unchanged on error).
+   * @see SubMatrix
+   */
+  MatrixStatus TrySubMatrix(const Matrix& other) noexcept {
+    return tryOperation(checkSumSub(other), [&] { SubMatrix(other); });
+  }
+  /**
+   * @brief Multiplies the current matrix by a scalar value without throwing.
+   * @param num The scalar value to multiply with.
+   * @return The error code (the matrix is unchanged on error).
+   * @see MulNumber
+   */
+  MatrixStatus TryMulNumber(const double num) noexcept;
+  /**
+   * @brief Multiplies the current matrix by another matrix without throwing.
+   * @param other The matrix to multiply with.
+   * @return The error code (the matrix is unchanged on error).
+   * @see MulMatrix
+   */
+  MatrixStatus TryMulMatrix(const Matrix& other) noexcept {
+    return tryOperation(checkMulMatrix(other), [&] { MulMatrix(other); });
+  }
+  /**
+   * @brief Calculates the determinant of the matrix without throwing.
+   * @param det Output parameter for the determinant.
+   * @return The error code (det is unchanged on error).
+   * @see Determinant
+   */
+  MatrixStatus TryDeterminant(double& det) const noexcept {
+    return tryOperation(checkSquare(), [&] { det = Determinant(); });
+  }
+  /**
+   * @brief Creates an inversed matrix without throwing.
+   * @param result Output parameter for the inversed matrix.
+   * @return The error code (result is unchanged on error).
+   * @see InverseMatrix
+   */
+  MatrixStatus TryInverseMatrix(Matrix& result) const noexcept;
+
+  // operators overload
+  /**
+   * @brief Ollows access (adjust or return) to the matrix's element with it's
+   * index.
+   * @return The value of the element.
+   */
+  MatrixElement operator()(const int row, const int col) const {
+    if (!matrix_) throw MatrixSetError();
+    if (row < 0 || col < 0 || row >= rows_ || col >= cols_)
+      throw OutOfRangeError();
+    return MatrixElement(*this, row, col);
+  }
+  /**
+   * @brief Overloading the "==" operator.
+   * @param other The matrix to compare with.
+   * @return True if the matrices are equal, false otherwise.
+   */
+  bool operator==(const Matrix& other) const {
+    return this->EqMatrix(other);
+  }
+  /**
+   * @brief Overloading the "=" (set) operator.
+   * @details The storage of other is shared as by the copy constructor.
+   * @param other The matrix to take values from with.
+   * @return Reference to the matrix values were set to.
+   */
+  Matrix& operator=(const Matrix& other) noexcept;
+  /**
+   * @brief Overloading the "+"(add) operator.
+   * @param other The matrix to add to the left one.
+   * @return Resulting matrix.
+   */
+  Matrix operator+(const Matrix& other) const {
+    return matrixSumSub(other, SumSub::Sum);
+  }
+  /**
+   * @brief Overloading the "-"(substraction) operator.
+   * @param other The matrix to substract.
+   * @return Resulting matrix.
+   */
+  Matrix operator-(const Matrix& other) const {
+    return matrixSumSub(other, SumSub::Sub);
+  }
+  /**
+   * @brief Overloading the "+="(addition assignment) operator.
+   * @param other The matrix to add.
+   * @return Resulting matrix reference.
+   */
+  Matrix& operator+=(const Matrix& other) {
+    this->SumMatrix(other);
+    return *this;
+  }
+  /**
+   * @brief Overloading the "-="(substraction assignment) operator.
+   * @param other The matrix to substract.
+   * @return Resulting matrix reference.
+   */
+  Matrix& operator-=(const Matrix& other) {
+    this->SubMatrix(other);
+    return *this;
+  }
+  /**
+   * @brief Overloading the "*"(multiplication) by a matrix operator.
+   * @param other The matrix to multiply by.
+   * @return Resulting matrix.
+   */
+  Matrix operator*(const Matrix& other) const {
+    return multiplyKernel(*this, false, other, false);
+  }
+  /**
+   * @brief Overloading the "*"(multiplication) by a transposed matrix operator
+   * (NT kernel).
+   * @param other The transposed matrix to multiply by.
+   * @return Resulting matrix.
+   */
+  Matrix operator*(const TransposedMatrix& other) const {
+    return multiplyKernel(*this, false, other.getOrigin(), true);
+  }
+  /**
+   * @brief Overloading the "*"(multiplication) by a number operator.
+   * @param other The number to multiply by.
+   * @return Resulting matrix.
+   */
+  Matrix operator*(const double num) const;
+  /**
+   * @brief Overloading the "*"(multiplication) by a vector operator (GEMV).
+   * @param x The vector to multiply by.
+   * @return Resulting vector.
+   */
+  Vector operator*(const Vector& x) const {
+    Vector y(rows_);
+    Gemv(1, x, 0, y);
+    return y;
+  }
+  /**
+   * @brief Overloading the "*="(multiplication assignment) by a matrix
+   * operator.
+   * @param other The matrix to multiply by.
+   * @return Resulting matrix reference.
+   */
+  Matrix& operator*=(const Matrix& other) {
+    this->MulMatrix(other);
+    return *this;
+  }
+  /**
+   * @brief Overloading the "*="(multiplication assignment) by a matrix
+   * operator.
+   * @param other The number to multiply by.
+   * @return Resulting matrix reference.
+   */
+  Matrix& operator*=(const double other) {
+    this->MulNumber(other);
+    return *this;
+  }
+};
+#endif  // MATRIX_CPP_H
@@ -0,0 +1,377 @@
+#ifndef MATRIX_ITERATOR
+#define MATRIX_ITERATOR
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * @brief A random access iterator over elements placed at a fixed distance
+ * from each other (a column of a matrix).
+ * @tparam T double or const double.
+ */
+template <typename T>
+class StridedIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  StridedIterator() noexcept = default;
+  /**
+   * @brief Constructs an iterator.
+   * @param element The element pointed to.
+   * @param stride The distance between consecutive elements.
+   */
+  StridedIterator(T* element, const difference_type stride) noexcept
+      : element_(element), stride_(stride) {}
+  /**
+   * @brief Converts a mutable iterator to a constant one.
+   * @param other The mutable iterator.
+   */
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+  StridedIterator(const StridedIterator<U>& other) noexcept
+      : element_(other.base()), stride_(other.stride()) {}
+
+  /**
+   * @brief Retrieves the element pointed to.
+   * @return Pointer to the element.
+   */
+  T* base() const noexcept { return element_; }
+  /**
+   * @brief Retrieves the distance between consecutive elements.
+   * @return The stride.
+   */
+  difference_type stride() const noexcept { return stride_; }
+
+  reference operator*() const noexcept { return *element_; }
+  pointer operator->() const noexcept { return element_; }
+  reference operator[](const difference_type n) const noexcept {
+    return element_[n * stride_];
+  }
+  StridedIterator& operator++() noexcept {
+    element_ += stride_;
+    return *this;
+  }
+  StridedIterator operator++(int) noexcept {
+    StridedIterator old = *this;
+    element_ += stride_;
+    return old;
+  }
+  StridedIterator& operator--() noexcept {
+    element_ -= stride_;
+    return *this;
+  }
+  StridedIterator operator--(int) noexcept {
+    StridedIterator old = *this;
+    element_ -= stride_;
+    return old;
+  }
+  StridedIterator& operator+=(const difference_type n) noexcept {
+    element_ += n * stride_;
+    return *this;
+  }
+  StridedIterator& operator-=(const difference_type n) noexcept {
+    element_ -= n * stride_;
+    return *this;
+  }
+  StridedIterator operator+(const difference_type n) const noexcept {
+    return StridedIterator(element_ + n * stride_, stride_);
+  }
+  friend StridedIterator operator+(const difference_type n,
+                                   const StridedIterator& it) noexcept {
+    return it + n;
+  }
+  StridedIterator operator-(const difference_type n) const noexcept {
+    return StridedIterator(element_ - n * stride_, stride_);
+  }
+  difference_type operator-(const StridedIterator& other) const noexcept {
+    return stride_ ? (element_ - other.element_) / stride_ : 0;
+  }
+  bool operator==(const StridedIterator& other) const noexcept {
+    return element_ == other.element_;
+  }
+  bool operator!=(const StridedIterator& other) const noexcept {
+    return element_ != other.element_;
+  }
+  bool operator<(const StridedIterator& other) const noexcept {
+    return *this - other < 0;
+  }
+  bool operator>(const StridedIterator& other) const noexcept {
+    return other < *this;
+  }
+  bool operator<=(const StridedIterator& other) const noexcept {
+    return !(other < *this);
+  }
+  bool operator>=(const StridedIterator& other) const noexcept {
+    return !(*this < other);
+  }
+
+ private:
+  T* element_ = nullptr;        ///< The element pointed to.
+  difference_type stride_ = 0;  ///< Distance between consecutive elements.
+};
+
+/**
+ * @brief A random access iterator over the elements of a padded row major
+ * storage, in row major order (the padding is skipped).
+ * @tparam T double or const double.
+ */
+template <typename T>
+class ElementIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  ElementIterator() noexcept = default;
+  /**
+   * @brief Constructs an iterator.
+   * @param row The start of the row of the element.
+   * @param col The column of the element.
+   * @param cols The number of columns.
+   * @param stride The distance between the starts of consecutive rows.
+   */
+  ElementIterator(T* row, const int col, const int cols,
+                  const int stride) noexcept
+      : row_(row), col_(col), cols_(cols), stride_(stride) {}
+  /**
+   * @brief Converts a mutable iterator to a constant one.
+   * @param other The mutable iterator.
+   */
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+  ElementIterator(const ElementIterator<U>& other) noexcept
+      : row_(other.row()),
+        col_(other.col()),
+        cols_(other.cols()),
+        stride_(other.stride()) {}
+
+  /**
+   * @brief Retrieves the start of the row of the element.
+   * @return Pointer to the row.
+   */
+  T* row() const noexcept { return row_; }
+  /**
+   * @brief Retrieves the column of the element.
+   * @return Column index.
+   */
+  int col() const noexcept { return col_; }
+  /**
+   * @brief Retrieves the number of columns.
+   * @return Number of columns.
+   */
+  int cols() const noexcept { return cols_; }
+  /**
+   * @brief Retrieves the distance between the starts of consecutive rows.
+   * @return The stride.
+   */
+  int stride() const noexcept { return stride_; }
+
+  reference operator*() const noexcept { return row_[col_]; }
+  pointer operator->() const noexcept { return row_ + col_; }
+  reference operator[](const difference_type n) const noexcept {
+    return *(*this + n);
+  }
+  ElementIterator& operator++() noexcept {
+    if (++col_ == cols_) {
+      col_ = 0;
+      row_ += stride_;
+    }
+    return *this;
+  }
+  ElementIterator operator++(int) noexcept {
+    ElementIterator old = *this;
+    ++*this;
+    return old;
+  }
+  ElementIterator& operator--() noexcept {
+    if (col_-- == 0) {
+      col_ = cols_ - 1;
+      row_ -= stride_;
+    }
+    return *this;
+  }
+  ElementIterator operator--(int) noexcept {
+    ElementIterator old = *this;
+    --*this;
+    return old;
+  }
+  ElementIterator& operator+=(const difference_type n) noexcept {
+    const difference_type col = col_ + n;
+    if (col >= 0 && col < cols_) {
+      col_ = static_cast<int>(col);
+    } else if (cols_) {
+      difference_type rows = col / cols_, rest = col % cols_;
+      if (rest < 0) {
+        rest += cols_;
+        rows--;
+      }
+      row_ += rows * stride_;
+      col_ = static_cast<int>(rest);
+    }
+    return *this;
+  }
+  ElementIterator& operator-=(const difference_type n) noexcept {
+    return *this += -n;
+  }
+  ElementIterator operator+(const difference_type n) const noexcept {
+    ElementIterator result = *this;
+    return result += n;
+  }
+  friend ElementIterator operator+(const difference_type n,
+                                   const ElementIterator& it) noexcept {
+    return it + n;
+  }
+  ElementIterator operator-(const difference_type n) const noexcept {
+    ElementIterator result = *this;
+    return result -= n;
+  }
+  difference_type operator-(const ElementIterator& other) const noexcept {
+    if (!stride_) return 0;
+    return (row_ - other.row_) / stride_ * cols_ + (col_ - other.col_);
+  }
+  bool operator==(const ElementIterator& other) const noexcept {
+    return row_ == other.row_ && col_ == other.col_;
+  }
+  bool operator!=(const ElementIterator& other) const noexcept {
+    return !(*this == other);
+  }
+  bool operator<(const ElementIterator& other) const noexcept {
+    return row_ < other.row_ || (row_ == other.row_ && col_ < other.col_);
+  }
+  bool operator>(const ElementIterator& other) const noexcept {
+    return other < *this;
+  }
+  bool operator<=(const ElementIterator& other) const noexcept {
+    return !(other < *this);
+  }
+  bool operator>=(const ElementIterator& other) const noexcept {
+    return !(*this < other);
+  }
+
+ private:
+  T* row_ = nullptr;  ///< The start of the row of the element.
+  int col_{0};        ///< The column of the element.
+  int cols_{0};       ///< Number of columns.
+  int stride_{0};     ///< Distance between the starts of consecutive rows.
+};
+
+/**
+ * @brief A pair of iterators usable in range based loops and algorithms.
+ * @tparam Iterator The iterator type.
+ */
+template <typename Iterator>
+class ElementRange {
+ public:
+  using iterator = Iterator;
+  using reference = typename std::iterator_traits<Iterator>::reference;
+
+  /**
+   * @brief Constructs a range.
+   * @param first The first element.
+   * @param last The position after the last element.
+   */
+  ElementRange(const Iterator first, const Iterator last) noexcept
+      : first_(first), last_(last) {}
+  Iterator begin() const noexcept { return first_; }
+  Iterator end() const noexcept { return last_; }
+  /**
+   * @brief Retrieves the number of elements.
+   * @return Number of elements.
+   */
+  std::ptrdiff_t size() const noexcept { return last_ - first_; }
+  /**
+   * @brief Accesses an element without bounds checking.
+   * @param index Index of the element.
+   * @return Reference to the element.
+   */
+  reference operator[](const std::ptrdiff_t index) const noexcept {
+    return first_[index];
+  }
+
+ private:
+  Iterator first_;  ///< The first element.
+  Iterator last_;   ///< The position after the last element.
+};
+
+/**
+ * @brief A view of a padded row major storage: its address, shape and
+ * leading dimension, as expected by buffer protocols and BLAS style APIs.
+ * @tparam T double or const double.
+ */
+template <typename T>
+class MatrixSpan {
+ public:
+  MatrixSpan() noexcept = default;
+  /**
+   * @brief Constructs a view.
+   * @param data The first element.
+   * @param rows The number of rows.
+   * @param cols The number of columns.
+   * @param stride The distance between the starts of consecutive rows.
+   */
+  MatrixSpan(T* data, const int rows, const int cols, const int stride) noexcept
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+  /**
+   * @brief Converts a mutable view to a constant one.
+   * @param other The mutable view.
+   */
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+  MatrixSpan(const MatrixSpan<U>& other) noexcept
+      : data_(other.data()),
+        rows_(other.rows()),
+        cols_(other.cols()),
+        stride_(other.stride()) {}
+
+  /**
+   * @brief Retrieves the first element.
+   * @return Pointer to the storage (nullptr for an empty view).
+   */
+  T* data() const noexcept { return data_; }
+  /**
+   * @brief Retrieves the number of rows.
+   * @return Number of rows.
+   */
+  int rows() const noexcept { return rows_; }
+  /**
+   * @brief Retrieves the number of columns.
+   * @return Number of columns.
+   */
+  int cols() const noexcept { return cols_; }
+  /**
+   * @brief Retrieves the distance between the starts of consecutive rows.
+   * @return The stride in elements.
+   */
+  int stride() const noexcept { return stride_; }
+  /**
+   * @brief Accesses an element without bounds checking.
+   * @param row Row index.
+   * @param col Column index.
+   * @return Reference to the element.
+   */
+  T& operator()(const int row, const int col) const noexcept {
+    return data_[static_cast<std::ptrdiff_t>(row) * stride_ + col];
+  }
+  /**
+   * @brief Retrieves one row.
+   * @param index Row index.
+   * @return Range over the elements of the row.
+   */
+  ElementRange<T*> row(const int index) const noexcept {
+    T* first = &(*this)(index, 0);
+    return ElementRange<T*>(first, first + cols_);
+  }
+
+ private:
+  T* data_ = nullptr;  ///< The first element.
+  int rows_{0};        ///< Number of rows.
+  int cols_{0};        ///< Number of columns.
+  int stride_{0};      ///< Distance between the starts of consecutive rows.
+};
+#endif  // MATRIX_ITERATOR
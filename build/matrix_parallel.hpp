@@ -0,0 +1,152 @@
+#ifndef MATRIX_PARALLEL
+#define MATRIX_PARALLEL
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "matrix_scheduler.hpp"
+#include "matrix_tuning.hpp"
+
+/**
+ * @brief Provides the parallel execution layer used by the heavy kernels of
+ * the library.
+ */
+namespace MatrixParallel {
+  /**
+   * @brief Retrieves the number of hardware threads available.
+   * @return Amount of threads (at least one).
+   */
+  inline static int threadCount() noexcept {
+    const unsigned count = std::thread::hardware_concurrency();
+    return count ? static_cast<int>(count) : 1;
+  }
+  /**
+   * @brief Calculates how many threads a loop of the given size deserves.
+   * @param size Number of loop iterations.
+   * @param work Approximate number of scalar operations per iteration.
+   * @return Amount of threads (at least one, at most size).
+   */
+  inline static int threadsFor(const int size, const long work) noexcept {
+    const long by_work =
+        static_cast<long>(size) * work / MatrixTuning::get().parallel_grain;
+    return static_cast<int>(
+        std::max(1L, std::min({by_work, static_cast<long>(threadCount()),
+                               static_cast<long>(size)})));
+  }
+  /**
+   * @brief Checks whether the reductions are deterministic.
+   * @return True if partial results follow a fixed blocking.
+   */
+  bool isDeterministic() noexcept;
+  /**
+   * @brief Switches deterministic reductions on or off (initially on if the
+   * MATRIX_DETERMINISTIC environment variable is set and not "0").
+   * @details When on, reductions split their range into REDUCTION_BLOCK sized
+   * blocks whatever the thread count, so results are bitwise reproducible
+   * across runs and machines with different core counts. When off, they use
+   * one block per thread.
+   * @param enabled Whether reductions are deterministic.
+   */
+  void setDeterministic(const bool enabled) noexcept;
+  /**
+   * @brief Sums values with a pairwise tree whose shape depends only on the
+   * number of values.
+   * @param values The values.
+   * @param count The number of values (positive).
+   * @return The sum.
+   */
+  inline static double pairwiseSum(const double* values, const int count) {
+    if (count == 1) return values[0];
+    const int half = count / 2;
+    return pairwiseSum(values, half) +
+           pairwiseSum(values + half, count - half);
+  }
+  /**
+   * @brief Splits [begin, end) into contiguous chunks and runs body on them.
+   * @details The calling thread processes the first chunk itself, chunk t is
+   * queued for worker t of the shared scheduler (which touched those pages
+   * first under MemoryPolicy::FirstTouch) and the caller helps running queued
+   * tasks until they are done, so the loop may be nested inside scheduler
+   * tasks.
+   * Small loops are run serially.
+   * @param begin The first index.
+   * @param end The index after the last one.
+   * @param work Approximate number of scalar operations per index.
+   * @param body Callable invoked as body(chunk_begin, chunk_end).
+   * @note The first exception thrown by any chunk is rethrown after all the
+   * chunks are finished.
+   */
+  template <typename Body>
+  void parallelFor(const int begin, const int end, const long work,
+                   Body&& body) {
+    if (end <= begin) return;
+    const int threads = threadsFor(end - begin, work);
+    if (threads == 1) {
+      body(begin, end);
+      return;
+    }
+    const int chunk = (end - begin + threads - 1) / threads;
+    std::vector<std::exception_ptr> errors(threads);
+    std::atomic<int> remaining(0);
+    MatrixScheduler& scheduler = MatrixScheduler::instance();
+    for (int t = 1; t < threads; t++) {
+      const int from = begin + t * chunk, to = std::min(end, from + chunk);
+      if (from >= to) break;
+      remaining++;
+      scheduler.push(
+          [&body, &errors, &remaining, t, from, to]() {
+            try {
+              body(from, to);
+            } catch (...) {
+              errors[t] = std::current_exception();
+            }
+            remaining--;
+          },
+          t);
+    }
+    try {
+      body(begin, std::min(end, begin + chunk));
+    } catch (...) {
+      errors[0] = std::current_exception();
+    }
+    while (remaining > 0) {
+      if (!scheduler.runPending()) std::this_thread::yield();
+    }
+    for (const std::exception_ptr& error : errors) {
+      if (error) std::rethrow_exception(error);
+    }
+  }
+  /**
+   * @brief Sums the partial results of the blocks of [begin, end) computed in
+   * parallel.
+   * @details The blocking follows isDeterministic(); partial results are
+   * combined by pairwiseSum().
+   * @param begin The first index.
+   * @param end The index after the last one.
+   * @param work Approximate number of scalar operations per index.
+   * @param partial Callable invoked as partial(block_begin, block_end),
+   * returning the sum of the block.
+   * @return The sum (zero for an empty range).
+   */
+  template <typename Partial>
+  double parallelSum(const int begin, const int end, const long work,
+                     Partial&& partial) {
+    if (end <= begin) return 0;
+    const int size = end - begin;
+    const int threads = threadsFor(size, work);
+    const int block = isDeterministic() ? REDUCTION_BLOCK
+                                        : (size + threads - 1) / threads;
+    const int blocks = (size + block - 1) / block;
+    std::vector<double> partials(blocks, 0);
+    parallelFor(0, blocks, work * block, [&](int from, int to) {
+      for (int b = from; b < to; b++) {
+        const int first = begin + b * block;
+        partials[b] = partial(first, std::min(end, first + block));
+      }
+    });
+    return pairwiseSum(partials.data(), blocks);
+  }
+}
+#endif  // MATRIX_PARALLEL
@@ -0,0 +1,156 @@
+#ifndef MATRIX_SCHEDULER
+#define MATRIX_SCHEDULER
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A work-stealing thread pool running the asynchronous operations and
+ * the parallel kernels of the library.
+ * @details Every worker owns a task queue: it takes its own newest tasks
+ * first and steals the oldest tasks of the other workers when it runs out.
+ * Tasks spawned from a worker go to its own queue, so recursive kernels keep
+ * their subtasks local; other threads may address the queue of a worker, so
+ * the chunks of a loop land on the same workers every time. Bound tasks run
+ * only on their worker and are never stolen. Threads waiting for a result help running tasks
+ * instead of blocking (see wait()), which makes nested spawning deadlock
+ * free.
+ */
+class MatrixScheduler {
+ public:
+  using Task = std::function<void()>;  ///< A unit of work.
+
+  /**
+   * @brief Starts a scheduler.
+   * @param workers The number of worker threads (at least one).
+   * @param pinned Whether every worker is pinned to its own CPU.
+   * @see MatrixNuma::pinThread
+   */
+  explicit MatrixScheduler(const int workers, const bool pinned = false);
+  /**
+   * @brief Stops the workers; tasks that were not started are dropped.
+   */
+  ~MatrixScheduler() noexcept;
+  MatrixScheduler(const MatrixScheduler&) = delete;
+  MatrixScheduler& operator=(const MatrixScheduler&) = delete;
+
+  /**
+   * @brief Retrieves the scheduler shared by the library (one worker per
+   * hardware thread, pinned if the MATRIX_PIN_THREADS environment variable is
+   * set to a value other than "0").
+   * @return Reference to the shared scheduler.
+   */
+  static MatrixScheduler& instance();
+  /**
+   * @brief Retrieves the number of worker threads.
+   * @return Number of workers.
+   */
+  int getWorkers() const noexcept { return static_cast<int>(threads_.size()); }
+  /**
+   * @brief Checks whether the workers are pinned to CPUs.
+   * @return True if the workers were pinned.
+   */
+  bool isPinned() const noexcept { return pinned_; }
+  /**
+   * @brief Pins every worker to its own CPU (if they are not pinned yet).
+   * @details The workers pin themselves before running their next bound
+   * task.
+   * @see MatrixNuma::pinThread
+   */
+  void pinWorkers();
+  /**
+   * @brief Queues a task (on the current worker's own queue when called from
+   * a worker).
+   * @param task The task to run.
+   * @param worker The queue used when called from another thread (wraps
+   * around the worker count; -1 spreads the tasks round robin).
+   */
+  void push(Task task, const int worker = -1);
+  /**
+   * @brief Queues a task that only the given worker runs.
+   * @param worker The index of the worker (wraps around the worker count).
+   * @param task The task to run.
+   */
+  void pushBound(const int worker, Task task);
+  /**
+   * @brief Runs one queued task on the calling thread, if there is one.
+   * @return True if a task was run, false otherwise.
+   */
+  bool runPending();
+  /**
+   * @brief Queues an operation and returns the future of its result.
+   * @param operation Callable without parameters.
+   * @return The future of the result (exceptions are stored in it).
+   */
+  template <typename Operation>
+  auto submit(Operation&& operation)
+      -> std::future<std::invoke_result_t<std::decay_t<Operation>&>> {
+    using Result = std::invoke_result_t<std::decay_t<Operation>&>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<Operation>(operation));
+    std::future<Result> future = task->get_future();
+    push([task]() { (*task)(); });
+    return future;
+  }
+  /**
+   * @brief Waits for a future while running queued tasks on the calling
+   * thread.
+   * @param future The future to wait for.
+   * @return The result of the future (its exception is rethrown).
+   */
+  template <typename Result>
+  Result wait(std::future<Result>& future) {
+    while (future.wait_for(std::chrono::seconds(0)) !=
+           std::future_status::ready) {
+      if (!runPending()) std::this_thread::yield();
+    }
+    return future.get();
+  }
+
+ private:
+  /**
+   * @brief A task queue owned by one worker.
+   */
+  struct Queue {
+    std::mutex mutex;       ///< Guards tasks and bound.
+    std::deque<Task> tasks;  ///< Pending tasks, the newest at the back.
+    std::deque<Task> bound;  ///< Tasks of this worker only, the oldest first.
+    std::atomic<int> bound_pending{0};  ///< Number of bound tasks.
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues_;  ///< One queue per worker.
+  std::vector<std::thread> threads_;            ///< The worker threads.
+  std::atomic<bool> pinned_{false};             ///< Whether workers are pinned.
+  std::atomic<bool> stop_{false};               ///< Set on destruction.
+  std::atomic<unsigned> next_queue_{0};  ///< Round robin for external pushes.
+  std::atomic<int> pending_{0};          ///< Number of queued tasks.
+  std::mutex sleep_mutex_;               ///< Guards sleeping workers.
+  std::condition_variable wake_;         ///< Wakes sleeping workers.
+
+  /**
+   * @brief The loop run by every worker thread.
+   * @param index The index of the worker.
+   */
+  void workerLoop(const int index);
+  /**
+   * @brief Takes a task: the oldest bound task of the calling worker, the
+   * newest one of its own queue or the oldest one of another queue.
+   * @param own The queue of the calling worker (-1 for other threads).
+   * @param task Output parameter for the task.
+   * @return True if a task was taken, false otherwise.
+   */
+  bool takeTask(const int own, Task& task);
+  /**
+   * @brief Retrieves the queue index of the calling thread.
+   * @return The worker index or -1 if the thread is not a worker.
+   */
+  int currentWorker() const noexcept;
+};
+#endif  // MATRIX_SCHEDULER
@@ -0,0 +1,187 @@
+#ifndef MATRIX_VECTOR_H
+#define MATRIX_VECTOR_H
+#include <exception>
+#include <string>
+
+#include "matrix_exceptions.hpp"
+#include "matrix_service.hpp"
+
+/**
+ * @brief A dense vector stored in one contiguous block.
+ * @note Methods without "noexcept" keyword include verios of throws.
+ * @see matrix_exceptions.hpp
+ */
+class Vector {
+ private:
+  int size_{0};            ///< Number of elements in the vector.
+  double* data_ = nullptr;  ///< Pointer to the allocated elements.
+
+  /**
+   * @brief Allocates zero initialized memory for size_ elements.
+   */
+  void allocateVector();
+  /**
+   * @brief Sets the data pointer to a null state and the size to zero.
+   */
+  void setNullVector() noexcept;
+  /**
+   * @brief Validates every element of the vector.
+   * @throws DataError if any element is NaN or infinite.
+   */
+  void validateData() const;
+
+ public:
+  /**
+   * @brief Default constructor.
+   */
+  Vector() noexcept : size_(0), data_(nullptr) {}
+  /**
+   * @brief Parametrized constructor with size (zero filled).
+   * @param size Number of elements.
+   */
+  explicit Vector(const int size);
+  /**
+   * @brief Parametrized constructor with size and values passed as array.
+   * @param size Number of elements.
+   * @param n Number of elements in the array.
+   * @param arr Array of values to initialize the vector.
+   */
+  Vector(const int size, const int n, const double arr[]) : Vector(size) {
+    setVector(n, arr);
+  }
+  /**
+   * @brief Copy constructor.
+   * @param other The vector to copy.
+   */
+  Vector(const Vector& other);
+  /**
+   * @brief Move constructor.
+   * @param other The vector to move.
+   */
+  Vector(Vector&& other) noexcept : size_(other.size_), data_(other.data_) {
+    other.setNullVector();
+  }
+  /**
+   * @brief Destructor.
+   */
+  ~Vector() noexcept;
+
+  // Getters and setters
+  /**
+   * @brief Retrieves the number of elements in the vector.
+   * @return Number of elements.
+   */
+  int getSize() const noexcept { return size_; }
+  /**
+   * @brief Retrieves the contiguous storage of the vector.
+   * @return Constant pointer to the first element.
+   */
+  const double* getData() const noexcept { return data_; }
+  /**
+   * @brief Retrieves the value of a specific element.
+   * @param index Index of the element.
+   * @return The value of the element.
+   */
+  double getElement(const int index) const {
+    if (index < 0 || index >= size_) throw OutOfRangeError();
+    return data_[index];
+  }
+  /**
+   * @brief Sets the value of a specific element.
+   * @param index Index of the element.
+   * @param value The value to assign.
+   */
+  void setElement(const int index, const double value) {
+    if (index < 0 || index >= size_) throw OutOfRangeError();
+    MatrixService::doubleLegit(value);
+    data_[index] = value;
+  }
+  /**
+   * @brief Sets the vector values from an array (the rest is zero filled).
+   * @param n The number of elements in the array.
+   * @param array The array of values.
+   */
+  void setVector(const int n, const double array[]);
+
+  // methods
+  /**
+   * @brief Checks vectors for equality.
+   * @param other The vector to compare with.
+   * @return True if the vectors are equal, false otherwise.
+   */
+  bool EqVector(const Vector& other) const;
+  /**
+   * @brief Calculates the dot product with another vector.
+   * @param other The vector to multiply by.
+   * @return The dot product.
+   */
+  double Dot(const Vector& other) const;
+  /**
+   * @brief Adds a scaled vector to the current one (this += alpha * x).
+   * @param alpha The scale of the added vector.
+   * @param x The vector to add.
+   */
+  void Axpy(const double alpha, const Vector& x);
+  /**
+   * @brief Calculates the 1-norm (sum of absolute values).
+   * @return The 1-norm of the vector.
+   */
+  double NormOne() const;
+  /**
+   * @brief Calculates the euclidean norm.
+   * @return The 2-norm of the vector.
+   */
+  double NormTwo() const;
+  /**
+   * @brief Calculates the infinity norm (maximum absolute value).
+   * @return The infinity norm of the vector.
+   */
+  double NormInf() const;
+
+  // operators overload
+  /**
+   * @brief Overloading the "==" operator.
+   * @param other The vector to compare with.
+   * @return True if the vectors are equal, false otherwise.
+   */
+  bool operator==(const Vector& other) const { return EqVector(other); }
+  /**
+   * @brief Overloading the "=" (set) operator.
+   * @param other The vector to take values from.
+   * @return Reference to the vector values were set to.
+   */
+  Vector& operator=(const Vector& other);
+  /**
+   * @brief Overloading the "=" (move) operator.
+   * @param other The vector to move.
+   * @return Reference to the vector values were moved to.
+   */
+  Vector& operator=(Vector&& other) noexcept;
+  /**
+   * @brief Unchecked access to a specific element.
+   * @param index Index of the element.
+   * @return Reference to the element.
+   */
+  double& operator[](const int index) noexcept { return data_[index]; }
+  /**
+   * @brief Unchecked constant access to a specific element.
+   * @param index Index of the element.
+   * @return The value of the element.
+   */
+  double operator[](const int index) const noexcept { return data_[index]; }
+  /**
+   * @brief Retrieves the mutable contiguous storage of the vector.
+   * @return Pointer to the first element.
+   */
+  double* data() noexcept { return data_; }
+  /**
+   * @brief Retrieves the contiguous storage of the vector.
+   * @return Constant pointer to the first element.
+   */
+  const double* data() const noexcept { return data_; }
+  double* begin() noexcept { return data_; }
+  double* end() noexcept { return data_ + size_; }
+  const double* begin() const noexcept { return data_; }
+  const double* end() const noexcept { return data_ + size_; }
+};
+#endif  // MATRIX_VECTOR_H
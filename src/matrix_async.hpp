@@ -0,0 +1,77 @@
+#ifndef MATRIX_ASYNC
+#define MATRIX_ASYNC
+#include <future>
+#include <utility>
+
+#include "matrix_cpp.hpp"
+#include "matrix_scheduler.hpp"
+
+/**
+ * @brief Provides asynchronous versions of the heavy operations.
+ * @details The operations run on the shared work-stealing scheduler and take
+ * copies of their operands, so the arguments may be modified or destroyed
+ * while the result is pending. Errors are reported through the futures.
+ */
+namespace MatrixAsync {
+  /**
+   * @brief Queues an arbitrary operation on the shared scheduler.
+   * @param operation Callable without parameters.
+   * @return The future of the result.
+   */
+  template <typename Operation>
+  inline static auto submit(Operation&& operation) {
+    return MatrixScheduler::instance().submit(
+        std::forward<Operation>(operation));
+  }
+  /**
+   * @brief Waits for a future, running queued tasks meanwhile; safe to call
+   * from inside a submitted operation.
+   * @param future The future to wait for.
+   * @return The result of the future.
+   */
+  template <typename Result>
+  inline static Result wait(std::future<Result>& future) {
+    return MatrixScheduler::instance().wait(future);
+  }
+  /**
+   * @brief Multiplies two matrices asynchronously.
+   * @param a The left operand.
+   * @param b The right operand.
+   * @return The future of the product.
+   */
+  inline static std::future<Matrix> multiply(const Matrix& a,
+                                             const Matrix& b) {
+    return submit([a, b]() { return a * b; });
+  }
+  /**
+   * @brief Calculates the inverse matrix asynchronously.
+   * @param a The matrix.
+   * @param precision The precision mode of the LU based inversion.
+   * @return The future of the inverse matrix.
+   */
+  inline static std::future<Matrix> inverse(
+      const Matrix& a, const Precision precision = Precision::Double) {
+    return submit([a, precision]() { return a.InverseMatrix(precision); });
+  }
+  /**
+   * @brief Calculates the determinant asynchronously.
+   * @param a The matrix.
+   * @return The future of the determinant.
+   */
+  inline static std::future<double> determinant(const Matrix& a) {
+    return submit([a]() { return a.Determinant(); });
+  }
+  /**
+   * @brief Solves A * X = B asynchronously.
+   * @param a The matrix of the system.
+   * @param b The right hand sides.
+   * @param precision The precision mode.
+   * @return The future of the solution.
+   */
+  inline static std::future<Matrix> solve(
+      const Matrix& a, const Matrix& b,
+      const Precision precision = Precision::Double) {
+    return submit([a, b, precision]() { return a.Solve(b, precision); });
+  }
+}
+#endif  // MATRIX_ASYNC
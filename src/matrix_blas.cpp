@@ -0,0 +1,128 @@
+#include "matrix_blas.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "matrix_parallel.hpp"
+#include "matrix_tuning.hpp"
+
+#ifdef MATRIX_BLAS
+// The Fortran interface is declared here, so no cblas or lapacke header is
+// needed (the hidden lengths of character arguments are not used by the
+// supported libraries for single characters).
+extern "C" {
+void dgemm_(const char* transa, const char* transb, const int* m, const int* n,
+            const int* k, const double* alpha, const double* a, const int* lda,
+            const double* b, const int* ldb, const double* beta, double* c,
+            const int* ldc);
+void dgetrf_(const int* m, const int* n, double* a, const int* lda, int* ipiv,
+             int* info);
+void dgetrs_(const char* trans, const int* n, const int* nrhs, const double* a,
+             const int* lda, const int* ipiv, double* b, const int* ldb,
+             int* info);
+void dgetri_(const int* n, double* a, const int* lda, const int* ipiv,
+             double* work, const int* lwork, int* info);
+}
+#else
+// Without a backend accepts() is false and the stubs below are never called.
+static void dgemm_(const char*, const char*, const int*, const int*,
+                   const int*, const double*, const double*, const int*,
+                   const double*, const int*, const double*, double*,
+                   const int*) {}
+static void dgetrf_(const int*, const int*, double*, const int*, int*,
+                    int* info) {
+  *info = 1;
+}
+static void dgetrs_(const char*, const int*, const int*, const double*,
+                    const int*, const int*, double*, const int*, int* info) {
+  *info = 1;
+}
+static void dgetri_(const int*, double*, const int*, const int*, double*,
+                    const int*, int* info) {
+  *info = 1;
+}
+#endif
+
+bool MatrixBlas::available() noexcept {
+#ifdef MATRIX_BLAS
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool MatrixBlas::accepts(const double order) noexcept {
+  return available() && !MatrixParallel::isDeterministic() &&
+         order >= MatrixTuning::get().blas_order;
+}
+
+void MatrixBlas::multiply(const bool a_trans, const bool b_trans, const int m,
+                          const int n, const int k, const double* a,
+                          const int lda, const double* b, const int ldb,
+                          double* c, const int ldc) noexcept {
+  // Row major storage is the column major transposed matrix, so the column
+  // major product c^T = op(b)^T * op(a)^T is computed.
+  const char trans_a = a_trans ? 'T' : 'N', trans_b = b_trans ? 'T' : 'N';
+  const double alpha = 1, beta = 0;
+  dgemm_(&trans_b, &trans_a, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c,
+         &ldc);
+}
+
+BlasLUDecomposition::BlasLUDecomposition(const double* data, const int stride,
+                                         const int n)
+    : n_(n), lu_(static_cast<size_t>(n) * n), pivots_(n) {
+  for (int i = 0; i < n_; i++) {
+    const double* row = data + static_cast<size_t>(i) * stride;
+    std::copy(row, row + n_, lu_.begin() + static_cast<size_t>(i) * n_);
+  }
+  int info = 0;
+  dgetrf_(&n_, &n_, lu_.data(), &n_, pivots_.data(), &info);
+  singular_ = info != 0;
+}
+
+double BlasLUDecomposition::determinant() const noexcept {
+  if (singular_) return 0;
+  double det = 1;
+  for (int i = 0; i < n_; i++) {
+    det *= lu_[static_cast<size_t>(i) * n_ + i];
+    if (pivots_[i] != i + 1) det = -det;
+  }
+  return det;
+}
+
+void BlasLUDecomposition::solve(const double* b, const int b_stride,
+                                const int m, double* x,
+                                const int x_stride) const {
+  // The factors are those of A^T, so A * x = b is solved as (A^T)^T * x = b
+  // with every right hand side stored as a column major column.
+  std::vector<double> columns(static_cast<size_t>(n_) * m);
+  for (int i = 0; i < n_; i++) {
+    for (int j = 0; j < m; j++)
+      columns[static_cast<size_t>(j) * n_ + i] =
+          b[static_cast<size_t>(i) * b_stride + j];
+  }
+  const char trans = 'T';
+  int info = 0;
+  dgetrs_(&trans, &n_, &m, lu_.data(), &n_, pivots_.data(), columns.data(),
+          &n_, &info);
+  for (int i = 0; i < n_; i++) {
+    for (int j = 0; j < m; j++)
+      x[static_cast<size_t>(i) * x_stride + j] =
+          columns[static_cast<size_t>(j) * n_ + i];
+  }
+}
+
+void BlasLUDecomposition::inverse(double* x, const int x_stride) const {
+  // (A^T)^-1 stored column major is A^-1 stored row major.
+  std::vector<double> result(lu_);
+  int info = 0, query = -1;
+  double size = 0;
+  dgetri_(&n_, result.data(), &n_, pivots_.data(), &size, &query, &info);
+  int lwork = std::max(n_, static_cast<int>(size));
+  std::vector<double> work(lwork);
+  dgetri_(&n_, result.data(), &n_, pivots_.data(), work.data(), &lwork, &info);
+  for (int i = 0; i < n_; i++) {
+    const double* row = result.data() + static_cast<size_t>(i) * n_;
+    std::copy(row, row + n_, x + static_cast<size_t>(i) * x_stride);
+  }
+}
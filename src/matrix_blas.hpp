@@ -0,0 +1,97 @@
+#ifndef MATRIX_BLAS_BACKEND
+#define MATRIX_BLAS_BACKEND
+#include <vector>
+
+/**
+ * @brief Routes large products and LU factorizations to an external BLAS and
+ * LAPACK library (OpenBLAS, BLIS with libflame...).
+ * @details The backend is compiled in with "make BACKEND=<library>", which
+ * defines MATRIX_BLAS and links the library. Operations of an order below
+ * TuningConfig::blas_order keep the built-in kernels, and so does
+ * deterministic mode, whose reproducibility the backend does not promise.
+ * All the functions below take row major storage with a stride.
+ */
+namespace MatrixBlas {
+  /**
+   * @brief Checks whether the library was built with a backend.
+   * @return True if a backend is compiled in.
+   */
+  bool available() noexcept;
+  /**
+   * @brief Checks whether an operation should go to the backend.
+   * @param order The order of the operation (the cube root of the amount of
+   * multiply-adds for products).
+   * @return True if a backend is compiled in, deterministic mode is off and
+   * the order reaches TuningConfig::blas_order.
+   */
+  bool accepts(const double order) noexcept;
+  /**
+   * @brief Calculates c = op(a) * op(b) with dgemm.
+   * @param a_trans Whether a is transposed.
+   * @param b_trans Whether b is transposed.
+   * @param m Number of rows of c.
+   * @param n Number of columns of c.
+   * @param k The inner dimension.
+   * @param a The left operand.
+   * @param lda The stride of a.
+   * @param b The right operand.
+   * @param ldb The stride of b.
+   * @param c The result (overwritten).
+   * @param ldc The stride of c.
+   */
+  void multiply(const bool a_trans, const bool b_trans, const int m,
+                const int n, const int k, const double* a, const int lda,
+                const double* b, const int ldb, double* c,
+                const int ldc) noexcept;
+}
+
+/**
+ * @brief LU decomposition with partial pivoting computed by the backend
+ * (dgetrf), with the interface of LUDecomposition.
+ * @details The row major matrix is factorized as the column major transposed
+ * matrix, which has the same determinant; solves and the inverse undo the
+ * transposition.
+ */
+class BlasLUDecomposition {
+ private:
+  int n_{0};                 ///< Order of the matrix.
+  std::vector<double> lu_;   ///< Factors of the transposed matrix.
+  std::vector<int> pivots_;  ///< Row interchanges, one based.
+  bool singular_{false};     ///< Whether a zero pivot was met.
+
+ public:
+  /**
+   * @brief Factorizes a square matrix.
+   * @param data The first element of the matrix.
+   * @param stride The distance between the starts of consecutive rows.
+   * @param n The order of the matrix.
+   */
+  BlasLUDecomposition(const double* data, const int stride, const int n);
+  /**
+   * @brief Checks if the matrix was found singular.
+   * @return True if the factors can not be used to solve systems.
+   */
+  bool isSingular() const noexcept { return singular_; }
+  /**
+   * @brief Calculates the determinant from the factors.
+   * @return The determinant (zero if the matrix is singular).
+   */
+  double determinant() const noexcept;
+  /**
+   * @brief Solves A * x = b for several right hand sides (dgetrs).
+   * @param b The right hand sides (n rows, m columns).
+   * @param b_stride The stride of b.
+   * @param m The number of right hand sides.
+   * @param x The solutions (n rows, m columns).
+   * @param x_stride The stride of x.
+   */
+  void solve(const double* b, const int b_stride, const int m, double* x,
+             const int x_stride) const;
+  /**
+   * @brief Calculates the inverse matrix (dgetri).
+   * @param x The inverse (n rows, n columns).
+   * @param x_stride The stride of x.
+   */
+  void inverse(double* x, const int x_stride) const;
+};
+#endif  // MATRIX_BLAS_BACKEND
@@ -1,6 +1,17 @@
 #include "matrix_cpp.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "matrix_blas.hpp"
 #include "matrix_exceptions.hpp"
+#include "matrix_lu.hpp"
+#include "matrix_numa.hpp"
+#include "matrix_parallel.hpp"
+#include "matrix_tuning.hpp"
 
 Matrix::Matrix(const int rows, const int cols) {
   if (rows <= 0 || cols <= 0) throw DimentionError();
@@ -9,99 +20,333 @@ Matrix::Matrix(const int rows, const int cols) {
   allocateMatrix();
 }
 
-void Matrix::allocateMatrix() {
-  matrix_ = new double*[rows_];
-  if (!matrix_) throw MemoryAllocationError();
+Matrix::Matrix(double* data, const int rows, const int cols, const int stride,
+               std::function<void(double*)> deleter) {
+  wrapExternal(data, rows, cols, stride);
+  external_->deleter = std::move(deleter);
+}
+
+Matrix::Matrix(const double* data, const int rows, const int cols,
+               const int stride) {
+  // The buffer is never written: writes see it as shared and copy it.
+  wrapExternal(const_cast<double*>(data), rows, cols, stride);
+  external_->read_only = true;
+}
+
+void Matrix::wrapExternal(double* data, const int rows, const int cols,
+                          const int stride) {
+  if (rows <= 0 || cols <= 0) throw DimentionError();
+  if (!data || stride < cols) throw InputError();
+  external_ = new (std::nothrow) ExternalStorage();
+  matrix_ = new (std::nothrow) double*[rows];
+  if (!external_ || !matrix_) {
+    delete external_;
+    delete[] matrix_;
+    external_ = nullptr;
+    matrix_ = nullptr;
+    throw MemoryAllocationError();
+  }
+  rows_ = rows;
+  cols_ = cols;
+  row_capacity_ = rows;
+  stride_ = stride;
+  data_ = data;
+  linkRows();
+}
 
-  for (int i = 0; i < rows_; ++i) {
-    matrix_[i] = new double[cols_]{0};
-    if (!matrix_[i]) {
-      freeMatrixPart(i);
+void Matrix::allocateMatrix() {
+  row_capacity_ = std::max(row_capacity_, rows_);
+  stride_ = MatrixService::paddedStride(std::max(stride_, cols_));
+  const size_t count = static_cast<size_t>(row_capacity_) * stride_;
+  if (count <= INLINE_ELEMENTS) {
+    matrix_ = inline_rows_;
+    data_ = inline_data_;
+    std::fill(data_, data_ + count, 0);
+  } else {
+    matrix_ = new (std::nothrow) double*[row_capacity_];
+    if (!matrix_) throw MemoryAllocationError();
+    double* block =
+        MatrixNuma::allocate(STORAGE_HEADER + count, row_capacity_);
+    if (!block) {
+      freeMatrix();
       throw MemoryAllocationError();
     }
+    new (block) std::atomic<long>(1);
+    data_ = block + STORAGE_HEADER;
   }
+  linkRows();
 }
 
-void Matrix::freeMatrixPart(const int n) noexcept {
-  if (matrix_) {
-    for (int i = 0; i < n; i++) delete[] matrix_[i];
+void Matrix::freeMatrix() noexcept {
+  // Inline storage is part of the object; the last matrix sharing a heap
+  // storage frees it.
+  if (!isInline() &&
+      (!data_ || references().fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+    if (external_) {
+      if (external_->deleter) external_->deleter(data_);
+      delete external_;
+    } else if (data_) {
+      MatrixNuma::deallocate(data_ - STORAGE_HEADER);
+    }
     delete[] matrix_;
-    matrix_ = nullptr;
   }
+  external_ = nullptr;
+  data_ = nullptr;
+  matrix_ = nullptr;
+}
+
+void Matrix::reallocateMatrix(const int row_capacity, const int stride) {
+  Matrix storage;
+  storage.rows_ = rows_;
+  storage.cols_ = cols_;
+  storage.row_capacity_ = row_capacity;
+  storage.stride_ = stride;
+  storage.allocateMatrix();
+  for (int i = 0; i < rows_; ++i)
+    std::copy(matrix_[i], matrix_[i] + cols_, storage.matrix_[i]);
+  replaceMatrix(storage);
 }
 
+struct Matrix::DerivedCache {
+  unsigned long version = 0;     ///< Version of the matrix the results match.
+  bool has_determinant = false;  ///< Whether determinant is set.
+  double determinant = 0;        ///< The memoized determinant.
+  bool has_inverse = false;      ///< Whether inverse is set.
+  Matrix inverse;                ///< The memoized inverse matrix.
+  std::mutex mutex;  ///< Guards the results shared by const readers.
+};
+
 Matrix::~Matrix() noexcept {
   freeMatrix();
   setNullMatrix();
+  delete cache_;
+  cache_ = nullptr;
+}
+
+void Matrix::setCaching(const bool enabled) {
+  if (enabled && !cache_) {
+    cache_ = new (std::nothrow) DerivedCache();
+    if (!cache_) throw MemoryAllocationError();
+    cache_->version = version_;
+  } else if (!enabled) {
+    delete cache_;
+    cache_ = nullptr;
+  }
+}
+
+std::unique_lock<std::mutex> Matrix::lockCache() const {
+  if (!cache_) return {};
+  std::unique_lock<std::mutex> lock(cache_->mutex);
+  if (cache_->version != version_) {
+    cache_->version = version_;
+    cache_->has_determinant = false;
+    cache_->has_inverse = false;
+    cache_->inverse.freeMatrix();
+    cache_->inverse.setNullMatrix();
+  }
+  return lock;
 }
 
-Matrix::Matrix(const Matrix& other) noexcept
-    : Matrix(other.rows_, other.cols_) {
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      this->matrix_[i][j] = other.matrix_[i][j];
+std::size_t Matrix::getHash() const noexcept {
+  if (!matrix_) return 0;
+  std::uint64_t lanes[4]{0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL,
+                         0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+  for (int i = 0; i < rows_; i++) {
+    const double* row = matrix_[i];
+    int j = 0;
+    for (; j + 3 < cols_; j += 4) {
+      for (int l = 0; l < 4; l++)
+        lanes[l] = MatrixService::hashMix(lanes[l], row[j + l]);
     }
+    for (; j < cols_; j++)
+      lanes[j & 3] = MatrixService::hashMix(lanes[j & 3], row[j]);
   }
+  std::uint64_t hash = (static_cast<std::uint64_t>(rows_) << 32) ^ cols_;
+  for (const std::uint64_t lane : lanes)
+    hash = (hash ^ lane) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<std::size_t>(hash ^ (hash >> 32));
 }
 
-double Matrix::getElement(const int row, const int col) const {
-  if (row >= rows_ || col >= cols_ || row < 0 || col < 0)
-    throw OutOfRangeError();
-  return matrix_[row][col];
+Matrix::Matrix(const Matrix& other) noexcept : rows_(0), cols_(0) {
+  shareMatrix(other);
 }
 
-void Matrix::setElement(const int row, const int col, const double value) {
-  if (row >= rows_ || col >= cols_ || row < 0 || col < 0)
-    throw OutOfRangeError();
-  if (!matrix_) throw MatrixSetError();
-  MatrixService::doubleLegit(value);
-  matrix_[row][col] = value;
+void Matrix::shareMatrix(const Matrix& other) noexcept {
+  // The reference is taken first, so a storage both matrices already share
+  // survives the release below.
+  if (other.data_ && !other.isInline())
+    other.references().fetch_add(1, std::memory_order_relaxed);
+  freeMatrix();
+  setNullMatrix();
+  if (other.matrix_) adoptStorage(other);
 }
 
-void Matrix::setMatrix(const int n, const double array[]) {
-  if (!matrix_) throw MatrixSetError();
-  if (n < 0 || !array) throw InputError();
-  if (n > rows_ * cols_) throw OutOfRangeError();
+void Matrix::adoptStorage(const Matrix& other) noexcept {
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  row_capacity_ = other.row_capacity_;
+  stride_ = other.stride_;
+  if (!other.isInline()) {
+    matrix_ = other.matrix_;
+    data_ = other.data_;
+    external_ = other.external_;
+    return;
+  }
+  matrix_ = inline_rows_;
+  data_ = inline_data_;
+  std::copy(other.data_, other.data_ + row_capacity_ * stride_, data_);
+  linkRows();
+}
 
+MatrixStatus Matrix::trySetMatrix(const int n, const double array[]) noexcept {
+  if (!matrix_) return MatrixStatus::MatrixSetError;
+  if (n < 0 || !array) return MatrixStatus::InputError;
+  if (n > rows_ * cols_) return MatrixStatus::OutOfRangeError;
+  for (int k = 0; k < n; k++) {
+    if (!MatrixService::doubleIsLegit(array[k])) return MatrixStatus::DataError;
+  }
+  const MatrixStatus status =
+      tryOperation(MatrixStatus::Ok, [this] { detach(); });
+  if (status != MatrixStatus::Ok) return status;
   for (int i = 0, k = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++, k++) {
-      if (k < n) {
-        MatrixService::doubleLegit(array[k]);
-        matrix_[i][j] = array[k];
-      } else
-        matrix_[i][j] = 0;
-    }
+    const int copied = std::max(0, std::min(cols_, n - k));
+    std::copy(array + k, array + k + copied, matrix_[i]);
+    std::fill(matrix_[i] + copied, matrix_[i] + cols_, 0);
+    k += cols_;
   }
+  touch();
+  return MatrixStatus::Ok;
+}
+
+MatrixStatus Matrix::trySetDimentions(const int rows,
+                                      const int columns) noexcept {
+  if (rows <= 0 || columns <= 0) return MatrixStatus::OutOfRangeError;
+  return tryOperation(MatrixStatus::Ok,
+                      [&] { setDimentions(rows, columns); });
+}
+
+MatrixStatus Matrix::TryMulNumber(const double num) noexcept {
+  MatrixStatus status = MatrixStatus::Ok;
+  if (!matrix_)
+    status = MatrixStatus::MatrixSetError;
+  else if (!MatrixService::doubleIsLegit(num) || !dataLegit())
+    status = MatrixStatus::DataError;
+  return tryOperation(status, [&] { MulNumber(num); });
+}
+
+MatrixStatus Matrix::TryInverseMatrix(Matrix& result) const noexcept {
+  // Only a singular matrix is detected by throwing.
+  return tryOperation(checkSquare(), [&] {
+    Matrix inverse(InverseMatrix());
+    result.replaceMatrix(inverse);
+  });
+}
+
+MatrixStatus Matrix::checkSquare() const noexcept {
+  if (!matrix_) return MatrixStatus::MatrixSetError;
+  if (rows_ != cols_) return MatrixStatus::SquarenessError;
+  if (!dataLegit()) return MatrixStatus::DataError;
+  return MatrixStatus::Ok;
+}
+
+MatrixStatus Matrix::checkSumSub(const Matrix& other) const noexcept {
+  if (!matrix_ || !other.matrix_) return MatrixStatus::MatrixSetError;
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    return MatrixStatus::DimentionEqualityError;
+  if (!dataLegit() || !other.dataLegit()) return MatrixStatus::DataError;
+  return MatrixStatus::Ok;
+}
+
+MatrixStatus Matrix::checkMulMatrix(const Matrix& other) const noexcept {
+  if (!matrix_ || !other.matrix_) return MatrixStatus::MatrixSetError;
+  if (cols_ != other.rows_) return MatrixStatus::DimentionAlignmentError;
+  if (!dataLegit() || !other.dataLegit()) return MatrixStatus::DataError;
+  return MatrixStatus::Ok;
 }
 
 std::unique_ptr<double[]> Matrix::getArrayFromMatrix() const {
   if (!matrix_) throw MatrixSetError();
   std::unique_ptr<double[]> array{std::make_unique<double[]>(rows_ * cols_)};
-  for (int i = 0, k = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++, k++) {
-      array[k] = matrix_[i][j];
-    }
-  }
+  for (int i = 0; i < rows_; i++)
+    std::copy(matrix_[i], matrix_[i] + cols_, array.get() + i * cols_);
   return array;
 }
 
 void Matrix::setDimentions(const int rows, const int columns) {
-  if (rows < rows_ || columns < cols_)
-    throw OutOfRangeError();
-  else if (rows > rows_ || columns > cols_) {
-    Matrix matrix2(rows, columns);
-    for (int i = 0; i < rows; i++) {
-      for (int j = 0; j < columns; j++) {
-        if (i < this->rows_ && j < this->cols_)
-          matrix2.setElement(i, j, this->matrix_[i][j]);
-        else
-          matrix2.setElement(i, j, 0);
-      }
-    }
-    replaceMatrix(matrix2);
+  if (rows <= 0 || columns <= 0) throw OutOfRangeError();
+  if (!matrix_) {
+    rows_ = rows;
+    cols_ = columns;
+    allocateMatrix();
+    touch();
+    return;
+  }
+  if (!fitsStorage(rows, columns))
+    reallocateMatrix(std::max(rows, row_capacity_),
+                     std::max(columns, getColCapacity()));
+  detach();
+  for (int i = 0; i < std::min(rows, rows_); i++)
+    std::fill(matrix_[i] + std::min(cols_, columns), matrix_[i] + columns, 0);
+  for (int i = rows_; i < rows; i++)
+    std::fill(matrix_[i], matrix_[i] + columns, 0);
+  rows_ = rows;
+  cols_ = columns;
+  touch();
+}
+
+void Matrix::reshapeZero(const int rows, const int columns) {
+  // The old contents are not kept, so a shared storage is not copied either.
+  if (matrix_ && (isShared() || !fitsStorage(rows, columns))) {
+    const int col_capacity = getColCapacity();
+    freeMatrix();
+    row_capacity_ = std::max(rows, row_capacity_);
+    stride_ = std::max(columns, col_capacity);
+  }
+  rows_ = rows;
+  cols_ = columns;
+  if (!matrix_) allocateMatrix();
+  for (int i = 0; i < rows_; i++) std::fill(matrix_[i], matrix_[i] + cols_, 0);
+  touch();
+}
+
+void Matrix::reserve(const int rows, const int columns) {
+  if (rows <= 0 || columns <= 0) throw OutOfRangeError();
+  if (!matrix_) {
+    row_capacity_ = std::max(row_capacity_, rows);
+    stride_ = std::max(stride_, columns);
+  } else if (!fitsStorage(rows, columns)) {
+    reallocateMatrix(std::max(rows, row_capacity_),
+                     std::max(columns, getColCapacity()));
   }
 }
 
+void Matrix::appendRow(const int n, const double row[]) {
+  if (n <= 0 || !row) throw InputError();
+  if (matrix_ && n > cols_) throw OutOfRangeError();
+  for (int j = 0; j < n; j++) MatrixService::doubleLegit(row[j]);
+  if (!matrix_) {
+    cols_ = n;
+    row_capacity_ = std::max(row_capacity_, 1);
+    allocateMatrix();
+  } else if (rows_ == row_capacity_) {
+    reallocateMatrix(2 * row_capacity_, getColCapacity());
+  } else {
+    detach();
+  }
+  std::copy(row, row + n, matrix_[rows_]);
+  std::fill(matrix_[rows_] + n, matrix_[rows_] + cols_, 0);
+  rows_++;
+  touch();
+}
+
+void Matrix::shrink_to_fit() {
+  // The padding of the rows is not unused capacity: a fresh matrix of the
+  // same shape gets it too.
+  if (matrix_ && (row_capacity_ > rows_ ||
+                  getColCapacity() > MatrixService::paddedStride(cols_)))
+    reallocateMatrix(rows_, cols_);
+}
+
 bool Matrix::EqMatrix(const Matrix& other) const {
   bool output = matrixDimentionEq(other);
   for (int i = 0; output && i < rows_; i++) {
@@ -122,26 +367,25 @@ void Matrix::setNullMatrix() noexcept {
   rows_ = 0;
   cols_ = 0;
   matrix_ = nullptr;
+  data_ = nullptr;
+  external_ = nullptr;
+  row_capacity_ = 0;
+  stride_ = 0;
 }
 
 Matrix& Matrix::operator=(const Matrix& other) noexcept {
   if (this != &other) {
-    this->~Matrix();
-    this->setDimentions(other.rows_, other.cols_);
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        this->matrix_[i][j] = other.matrix_[i][j];
-      }
-    }
+    touch();
+    shareMatrix(other);
   }
   return *this;
 }
 
 void Matrix::replaceMatrix(Matrix& other) noexcept {
-  this->~Matrix();
-  this->rows_ = other.rows_;
-  this->cols_ = other.cols_;
-  this->matrix_ = other.matrix_;
+  freeMatrix();
+  touch();
+  other.touch();
+  adoptStorage(other);
   other.setNullMatrix();
 }
 
@@ -171,33 +415,381 @@ Matrix Matrix::matrixSumSub(const Matrix& other,
 Matrix Matrix::operator*(const double num) const {
   if (!matrix_) throw MatrixSetError();
   MatrixService::doubleLegit(num);
-  Matrix result = *this;
-  for (int i = 0; i < result.rows_; i++) {
-    for (int j = 0; j < result.cols_; j++) {
-      MatrixService::doubleLegit(result.matrix_[i][j]);
-      result.matrix_[i][j] = result.matrix_[i][j] * num;
+  Matrix result(rows_, cols_);
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      MatrixService::doubleLegit(matrix_[i][j]);
+      result.matrix_[i][j] = matrix_[i][j] * num;
     }
   }
   return result;
 }
 
-Matrix Matrix::operator*(const Matrix& other) const {
-  if (!matrix_ || !other.matrix_) throw MatrixSetError();
-  if (cols_ != other.rows_) throw DimentionAlignmentError();
-  Matrix result(rows_, other.cols_);
-  for (int i = 0; i < result.rows_; i++) {
-    for (int j = 0; j < result.cols_; j++) {
-      result.matrix_[i][j] = 0;
-      for (int k = 0; k < cols_; k++) {
-        MatrixService::doubleLegit(this->matrix_[i][k]);
-        MatrixService::doubleLegit(other.matrix_[k][j]);
-        result.matrix_[i][j] += ((matrix_[i][k]) * (other.matrix_[k][j]));
+Matrix Matrix::HadamardProduct(const Matrix& other) const {
+  return Zip(*this, other, [](double a, double b) { return a * b; });
+}
+
+Matrix Matrix::HadamardDivision(const Matrix& other) const {
+  return Zip(*this, other, [](double a, double b) { return a / b; });
+}
+
+Matrix Matrix::Clamp(const double low, const double high) const {
+  MatrixService::doubleLegit(low);
+  MatrixService::doubleLegit(high);
+  if (low > high) throw InputError();
+  return Map(
+      [low, high](double x) { return std::min(std::max(x, low), high); });
+}
+
+Matrix Matrix::Exp() const {
+  return Map([](double x) { return std::exp(x); });
+}
+
+Matrix Matrix::Log() const {
+  return Map([](double x) { return std::log(x); });
+}
+
+Matrix Matrix::Tanh() const {
+  return Map([](double x) { return std::tanh(x); });
+}
+
+/**
+ * @brief Calls body(transform, combine, identity) with the element
+ * transformation, the accumulation and the initial value of a reduction.
+ * @param kind The reduction.
+ * @param body Generic callable receiving the two functions.
+ */
+template <typename Body>
+static void withReduction(const Reduction kind, Body&& body) {
+  const auto identity = [](double x) { return x; };
+  const auto absolute = [](double x) { return std::fabs(x); };
+  const auto square = [](double x) { return x * x; };
+  const auto add = [](double a, double b) { return a + b; };
+  const auto lower = [](double a, double b) { return b < a ? b : a; };
+  const auto higher = [](double a, double b) { return b > a ? b : a; };
+  const double infinity = std::numeric_limits<double>::infinity();
+  switch (kind) {
+    case Reduction::Sum:
+    case Reduction::Mean:
+      body(identity, add, 0.0);
+      break;
+    case Reduction::Min:
+      body(identity, lower, infinity);
+      break;
+    case Reduction::Max:
+      body(identity, higher, -infinity);
+      break;
+    case Reduction::NormOne:
+      body(absolute, add, 0.0);
+      break;
+    case Reduction::NormTwo:
+      body(square, add, 0.0);
+      break;
+    case Reduction::NormInf:
+      body(absolute, higher, 0.0);
+      break;
+  }
+}
+
+/**
+ * @brief Finishes a reduction of count elements.
+ * @param kind The reduction.
+ * @param value The accumulated value.
+ * @param count The number of reduced elements.
+ * @return The result.
+ */
+static double finishReduction(const Reduction kind, const double value,
+                              const long count) {
+  double result = value;
+  if (kind == Reduction::Mean) result = value / count;
+  if (kind == Reduction::NormTwo) result = std::sqrt(value);
+  MatrixService::doubleLegit(result);
+  return result;
+}
+
+/**
+ * @brief Reduces a contiguous range with four independent accumulators, so
+ * that the loop vectorizes.
+ * @param x The first element.
+ * @param n The number of elements.
+ * @param transform The element transformation.
+ * @param combine The accumulation.
+ * @param identity The initial value of the accumulators.
+ * @return The accumulated value.
+ */
+template <typename Transform, typename Combine>
+static double reduceLanes(const double* x, const int n, Transform transform,
+                          Combine combine, const double identity) {
+  double s0 = identity, s1 = identity, s2 = identity, s3 = identity;
+  int j = 0;
+  for (; j + 3 < n; j += 4) {
+    s0 = combine(s0, transform(x[j]));
+    s1 = combine(s1, transform(x[j + 1]));
+    s2 = combine(s2, transform(x[j + 2]));
+    s3 = combine(s3, transform(x[j + 3]));
+  }
+  for (; j < n; j++) s0 = combine(s0, transform(x[j]));
+  return combine(combine(s0, s1), combine(s2, s3));
+}
+
+std::vector<double> Matrix::rowPartials(const Reduction kind) const {
+  if (!matrix_) throw MatrixSetError();
+  std::vector<double> partials(rows_);
+  withReduction(kind, [&](auto transform, auto combine, double identity) {
+    forEachRow([&](const int i) {
+      partials[i] =
+          reduceLanes(matrix_[i], cols_, transform, combine, identity);
+    });
+  });
+  return partials;
+}
+
+double Matrix::Reduce(const Reduction kind) const {
+  const std::vector<double> partials = rowPartials(kind);
+  double value = partials[0];
+  withReduction(kind, [&](auto, auto combine, double) {
+    for (int i = 1; i < rows_; i++) value = combine(value, partials[i]);
+  });
+  return finishReduction(kind, value, static_cast<long>(rows_) * cols_);
+}
+
+Vector Matrix::ReduceRows(const Reduction kind) const {
+  const std::vector<double> partials = rowPartials(kind);
+  Vector result(rows_);
+  for (int i = 0; i < rows_; i++)
+    result[i] = finishReduction(kind, partials[i], cols_);
+  return result;
+}
+
+Vector Matrix::ReduceCols(const Reduction kind) const {
+  if (!matrix_) throw MatrixSetError();
+  Vector result(cols_);
+  double* out = result.data();
+  withReduction(kind, [&](auto transform, auto combine, double identity) {
+    MatrixParallel::parallelFor(0, cols_, rows_, [&](int from, int to) {
+      std::fill(out + from, out + to, identity);
+      for (int i = 0; i < rows_; i++) {
+        const double* row = matrix_[i];
+        for (int j = from; j < to; j++)
+          out[j] = combine(out[j], transform(row[j]));
+      }
+    });
+  });
+  for (int j = 0; j < cols_; j++)
+    out[j] = finishReduction(kind, out[j], rows_);
+  return result;
+}
+
+void Matrix::ArgMax(int& row, int& col) const {
+  const std::vector<double> partials = rowPartials(Reduction::Max);
+  const int best =
+      std::max_element(partials.begin(), partials.end()) - partials.begin();
+  row = best;
+  col = std::find(matrix_[best], matrix_[best] + cols_, partials[best]) -
+        matrix_[best];
+}
+
+std::vector<int> Matrix::ArgMaxRows() const {
+  const std::vector<double> partials = rowPartials(Reduction::Max);
+  std::vector<int> result(rows_);
+  forEachRow([&](const int i) {
+    result[i] = std::find(matrix_[i], matrix_[i] + cols_, partials[i]) -
+                matrix_[i];
+  });
+  return result;
+}
+
+std::vector<int> Matrix::ArgMaxCols() const {
+  if (!matrix_) throw MatrixSetError();
+  std::vector<int> result(cols_, 0);
+  std::vector<double> best(matrix_[0], matrix_[0] + cols_);
+  MatrixParallel::parallelFor(0, cols_, rows_, [&](int from, int to) {
+    for (int i = 1; i < rows_; i++) {
+      const double* row = matrix_[i];
+      for (int j = from; j < to; j++) {
+        if (row[j] > best[j]) {
+          best[j] = row[j];
+          result[j] = i;
+        }
       }
     }
-  }
+  });
   return result;
 }
 
+double Matrix::Norm(const MatrixNorm kind) const {
+  if (kind == MatrixNorm::Frobenius) return Reduce(Reduction::NormTwo);
+  const Vector sums = kind == MatrixNorm::One ? ReduceCols(Reduction::NormOne)
+                                              : ReduceRows(Reduction::NormOne);
+  return *std::max_element(sums.begin(), sums.end());
+}
+
+double Matrix::Trace() const {
+  if (!matrix_) throw MatrixSetError();
+  if (rows_ != cols_) throw SquarenessError();
+  double trace = 0;
+  for (int i = 0; i < rows_; i++) trace += matrix_[i][i];
+  MatrixService::doubleLegit(trace);
+  return trace;
+}
+
+double Matrix::Dot(const Matrix& other) const {
+  if (!matrixDimentionEq(other)) throw DimentionEqualityError();
+  std::vector<double> partials(rows_);
+  forEachRow([&](const int i) {
+    partials[i] =
+        MatrixService::dotProduct(matrix_[i], other.matrix_[i], cols_);
+  });
+  const double dot = MatrixParallel::pairwiseSum(partials.data(), rows_);
+  MatrixService::doubleLegit(dot);
+  return dot;
+}
+
+Matrix Matrix::multiplyKernel(const Matrix& a, const bool a_trans,
+                              const Matrix& b, const bool b_trans) {
+  Matrix result;
+  multiplyInto(a, a_trans, b, b_trans, result);
+  return result;
+}
+
+void Matrix::multiplyInto(const Matrix& a, const bool a_trans,
+                          const Matrix& b, const bool b_trans,
+                          Matrix& result) {
+  if (!a.matrix_ || !b.matrix_) throw MatrixSetError();
+  const int m = a_trans ? a.cols_ : a.rows_, k = a_trans ? a.rows_ : a.cols_;
+  const int n = b_trans ? b.rows_ : b.cols_;
+  if (k != (b_trans ? b.cols_ : b.rows_)) throw DimentionAlignmentError();
+  a.validateData();
+  if (&a != &b) b.validateData();
+  if (MatrixBlas::accepts(std::cbrt(double(m) * n * k))) {
+    result.reshapeZero(m, n);
+    MatrixBlas::multiply(a_trans, b_trans, m, n, k, a.data_, a.stride_,
+                         b.data_, b.stride_, result.data_, result.stride_);
+    return;
+  }
+  if (a_trans && b_trans) {
+    result = multiplyKernel(b, false, a, false).Transpose();
+    return;
+  }
+
+  result.reshapeZero(m, n);
+  double** c = result.matrix_;
+  const bool gram = (&a == &b) && (a_trans != b_trans);
+  // Rows of the result are independent, so they are split between tasks.
+  // The depth is walked in panels so a panel of b stays in cache for all the
+  // rows of a task; every element still accumulates in the same order.
+  const int block = MatrixTuning::get().multiply_block;
+  MatrixParallel::parallelFor(0, m, 2L * k * n, [&](int from, int to) {
+    if (!a_trans && !b_trans) {
+      for (int pp = 0; pp < k; pp += block) {
+        const int p_end = std::min(pp + block, k);
+        for (int i = from; i < to; i++) {
+          for (int p = pp; p < p_end; p++) {
+            const double a_ip = a.matrix_[i][p];
+            for (int j = 0; j < n; j++) c[i][j] += a_ip * b.matrix_[p][j];
+          }
+        }
+      }
+    } else if (b_trans) {
+      for (int i = from; i < to; i++) {
+        for (int j = gram ? i : 0; j < n; j++) {
+          double sum = 0;
+          for (int p = 0; p < k; p++)
+            sum += a.matrix_[i][p] * b.matrix_[j][p];
+          c[i][j] = sum;
+        }
+      }
+    } else {
+      for (int p = 0; p < k; p++) {
+        for (int i = from; i < to; i++) {
+          const double a_pi = a.matrix_[p][i];
+          for (int j = gram ? i : 0; j < n; j++)
+            c[i][j] += a_pi * b.matrix_[p][j];
+        }
+      }
+    }
+  });
+  if (gram) {
+    for (int i = 1; i < m; i++) {
+      for (int j = 0; j < i; j++) c[i][j] = c[j][i];
+    }
+  }
+}
+
+Matrix Matrix::MultiplyChain(
+    const std::vector<std::reference_wrapper<const Matrix>>& chain) {
+  if (chain.empty()) throw InputError();
+  const int count = static_cast<int>(chain.size());
+  std::vector<long> dims(count + 1);
+  for (int i = 0; i < count; i++) {
+    const Matrix& factor = chain[i];
+    if (!factor.matrix_) throw MatrixSetError();
+    if (i && chain[i - 1].get().cols_ != factor.rows_)
+      throw DimentionAlignmentError();
+    dims[i] = factor.rows_;
+  }
+  dims[count] = chain.back().get().cols_;
+  if (count == 1) {
+    chain[0].get().validateData();
+    return chain[0];
+  }
+
+  // cost[i][j] is the cheapest way to multiply factors i..j, split[i][j] the
+  // last product it performs: (i..split) * (split+1..j).
+  std::vector<long> cost(count * count, 0);
+  std::vector<int> split(count * count, 0);
+  for (int length = 2; length <= count; length++) {
+    for (int i = 0; i + length <= count; i++) {
+      const int j = i + length - 1;
+      cost[i * count + j] = std::numeric_limits<long>::max();
+      for (int s = i; s < j; s++) {
+        const long candidate = cost[i * count + s] + cost[(s + 1) * count + j] +
+                               dims[i] * dims[s + 1] * dims[j + 1];
+        if (candidate < cost[i * count + j]) {
+          cost[i * count + j] = candidate;
+          split[i * count + j] = s;
+        }
+      }
+    }
+  }
+
+  // Operands are referred to by id: factors as -1 - index, intermediate
+  // results as buffer indices. Finished buffers are recycled.
+  std::vector<Matrix> buffers(count - 1);
+  std::vector<int> spare;
+  int used = 0;
+  auto operand = [&](const int id) -> const Matrix& {
+    return id < 0 ? chain[-1 - id].get() : buffers[id];
+  };
+  std::function<int(int, int)> evaluate = [&](const int i, const int j) {
+    if (i == j) return -1 - i;
+    const int left = evaluate(i, split[i * count + j]);
+    const int right = evaluate(split[i * count + j] + 1, j);
+    int target = used;
+    if (spare.empty()) {
+      used++;
+    } else {
+      target = spare.back();
+      spare.pop_back();
+    }
+    multiplyInto(operand(left), false, operand(right), false,
+                 buffers[target]);
+    if (left >= 0) spare.push_back(left);
+    if (right >= 0) spare.push_back(right);
+    return target;
+  };
+  return std::move(buffers[evaluate(0, count - 1)]);
+}
+
+bool Matrix::dataLegit() const noexcept {
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      if (!MatrixService::doubleIsLegit(matrix_[i][j])) return false;
+    }
+  }
+  return true;
+}
+
 // template <typename T>       //sad
 // Matrix& Matrix::operator*=(const T& other){
 //     std::variant< double, Matrix> v{other};
@@ -209,20 +801,6 @@ Matrix Matrix::operator*(const Matrix& other) const {
 //     return *this;
 // }
 
-Matrix::MatrixElement Matrix::operator()(const int row,
-                                               const int col) const {
-  if (!matrix_) throw MatrixSetError();
-  if (row < 0 || col < 0 || row >= rows_ || col >= cols_)
-    throw OutOfRangeError();
-  return MatrixElement(*this, row, col);
-}
-
-double Matrix::MatrixElement::operator=(const double input) { 
-  if (!ptr) throw MatrixSetError();
-  MatrixService::doubleLegit(input);
-  *ptr = input;
-  return input;
-}
 
 void Matrix::print_matrix() const noexcept {
   using std::cout, std::endl;
@@ -236,18 +814,49 @@ void Matrix::print_matrix() const noexcept {
   }
 }
 
-Matrix Matrix::Transpose() const {
+Matrix::TransposedMatrix Matrix::Transpose() const {
   if (!matrix_) throw MatrixSetError();
-  Matrix new_matrix(cols_, rows_);
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      new_matrix.matrix_[j][i] = matrix_[i][j];
+  return TransposedMatrix(*this);
+}
+
+Matrix::TransposedMatrix::operator Matrix() const {
+  const Matrix& origin = *origin_;
+  Matrix new_matrix(origin.cols_, origin.rows_);
+  const int block = MatrixTuning::get().transpose_block;
+  for (int ii = 0; ii < origin.rows_; ii += block) {
+    const int i_end = std::min(ii + block, origin.rows_);
+    for (int jj = 0; jj < origin.cols_; jj += block) {
+      const int j_end = std::min(jj + block, origin.cols_);
+      for (int i = ii; i < i_end; i++) {
+        for (int j = jj; j < j_end; j++)
+          new_matrix.matrix_[j][i] = origin.matrix_[i][j];
+      }
     }
   }
   return new_matrix;
 }
 
 double Matrix::Determinant() const {
+  if (auto lock = lockCache(); lock && cache_->has_determinant)
+    return cache_->determinant;
+  double det = 0;
+  if (matrix_ && rows_ == cols_ && MatrixBlas::accepts(rows_)) {
+    validateData();
+    det = BlasLUDecomposition(data_, stride_, rows_).determinant();
+  } else if (matrix_ && rows_ == cols_ && rows_ > COFACTOR_ORDER) {
+    validateData();
+    det = LUDecomposition<double>(matrix_, rows_).determinant();
+  } else {
+    det = determinantCofactor();
+  }
+  if (auto lock = lockCache()) {
+    cache_->determinant = det;
+    cache_->has_determinant = true;
+  }
+  return det;
+}
+
+double Matrix::determinantCofactor() const {
   if (!matrix_) throw MatrixSetError();
   if (rows_ != cols_) throw SquarenessError();
   double det = 0;
@@ -256,7 +865,8 @@ double Matrix::Determinant() const {
   else {
     for (int i = 0; i < rows_; i++) {
       MatrixService::doubleLegit(matrix_[0][i]);
-      det += pow(-1, i) * matrix_[0][i] * minorMaker(0, i).Determinant();
+      det += pow(-1, i) * matrix_[0][i] *
+             minorMaker(0, i).determinantCofactor();
     }
   }
   return det;
@@ -287,15 +897,418 @@ Matrix Matrix::CalcComplements() const {
     for (int i = 0; i < rows_; i++) {
       for (int j = 0; j < cols_; j++)
         new_matrix.matrix_[i][j] =
-            minorMaker(i, j).Determinant() * pow(-1, (i + j));
+            minorMaker(i, j).determinantCofactor() * pow(-1, (i + j));
     }
   }
   return new_matrix;
 }
 
 Matrix Matrix::InverseMatrix() const {
-  double inverse_determinamt = Determinant();
-  if (inverse_determinamt == 0) throw NonInvertibleError();
-  inverse_determinamt = 1.0 / inverse_determinamt;
-  return CalcComplements().Transpose() * inverse_determinamt;
+  if (auto lock = lockCache(); lock && cache_->has_inverse)
+    return cache_->inverse;
+  if (matrix_ && rows_ == cols_ && MatrixBlas::accepts(rows_)) {
+    validateData();
+    const BlasLUDecomposition lu(data_, stride_, rows_);
+    if (lu.isSingular()) throw NonInvertibleError();
+    Matrix inverse(rows_, rows_);
+    lu.inverse(inverse.data_, inverse.stride_);
+    if (auto lock = lockCache()) {
+      cache_->determinant = lu.determinant();
+      cache_->has_determinant = true;
+      cache_->inverse = inverse;
+      cache_->has_inverse = true;
+    }
+    return inverse;
+  }
+  Matrix inverse;
+  if (matrix_ && rows_ == cols_ && rows_ > COFACTOR_ORDER) {
+    inverse = InverseMatrix(Precision::Double);
+  } else {
+    const double determinant = Determinant();
+    if (determinant == 0) throw NonInvertibleError();
+    inverse = inverseFromDeterminant(determinant);
+  }
+  if (auto lock = lockCache()) {
+    cache_->inverse = inverse;
+    cache_->has_inverse = true;
+  }
+  return inverse;
+}
+
+Matrix Matrix::inverseFromDeterminant(const double det) const {
+  return CalcComplements().Transpose() * (1.0 / det);
+}
+
+Matrix Matrix::gaussJordanInverse(double& det) const {
+  if (!matrix_) throw MatrixSetError();
+  if (rows_ != cols_) throw SquarenessError();
+  const int n = rows_;
+  Matrix work(*this), inverse(n, n);
+  work.detach();
+  for (int i = 0; i < n; i++) inverse.matrix_[i][i] = 1;
+  det = 1;
+  for (int col = 0; col < n; col++) {
+    int pivot = col;
+    for (int i = col + 1; i < n; i++) {
+      if (fabs(work.matrix_[i][col]) > fabs(work.matrix_[pivot][col]))
+        pivot = i;
+    }
+    if (work.matrix_[pivot][col] == 0) {
+      det = 0;
+      return Matrix();
+    }
+    if (pivot != col) {
+      std::swap_ranges(work.matrix_[pivot], work.matrix_[pivot] + n,
+                       work.matrix_[col]);
+      std::swap_ranges(inverse.matrix_[pivot], inverse.matrix_[pivot] + n,
+                       inverse.matrix_[col]);
+      det = -det;
+    }
+    const double p = work.matrix_[col][col];
+    det *= p;
+    for (int j = 0; j < n; j++) {
+      work.matrix_[col][j] /= p;
+      inverse.matrix_[col][j] /= p;
+    }
+    for (int i = 0; i < n; i++) {
+      const double f = work.matrix_[i][col];
+      if (i == col || f == 0) continue;
+      for (int j = 0; j < n; j++) {
+        work.matrix_[i][j] -= f * work.matrix_[col][j];
+        inverse.matrix_[i][j] -= f * inverse.matrix_[col][j];
+      }
+    }
+  }
+  return inverse;
+}
+
+double Matrix::normOne() const noexcept {
+  double norm = 0;
+  for (int j = 0; j < cols_; j++) {
+    double sum = 0;
+    for (int i = 0; i < rows_; i++) sum += fabs(matrix_[i][j]);
+    if (sum > norm) norm = sum;
+  }
+  return norm;
+}
+
+double Matrix::normInf() const noexcept {
+  double norm = 0;
+  for (int i = 0; i < rows_; i++) {
+    double sum = 0;
+    for (int j = 0; j < cols_; j++) sum += fabs(matrix_[i][j]);
+    if (sum > norm) norm = sum;
+  }
+  return norm;
+}
+
+void Matrix::LowRankUpdate(const Matrix& u, const Matrix& v, Matrix& inverse,
+                           double& det) {
+  if (!matrix_ || !u.matrix_ || !v.matrix_ || !inverse.matrix_)
+    throw MatrixSetError();
+  if (rows_ != cols_) throw SquarenessError();
+  if (!u.matrixDimentionEq(v) || !matrixDimentionEq(inverse))
+    throw DimentionEqualityError();
+  if (u.rows_ != rows_) throw DimentionAlignmentError();
+  MatrixService::doubleLegit(det);
+  const int n = rows_, k = u.cols_;
+  Matrix updated(*this + u * v.Transpose());
+
+  // Z = A^-1 * U and W = V^T * A^-1, both O(n^2 k).
+  Matrix z(inverse * u), w(v.Transpose() * inverse);
+  // Capacitance matrix C = I + V^T * A^-1 * U.
+  Matrix capacitance(w * u);
+  for (int i = 0; i < k; i++) capacitance.matrix_[i][i] += 1;
+  double cap_det = 0;
+  Matrix cap_inverse(capacitance.gaussJordanInverse(cap_det));
+
+  if (cap_det != 0 && 1.0 / (capacitance.normOne() * cap_inverse.normOne()) >=
+                          UPDATE_RCOND_LIMIT) {
+    Matrix correction(z * cap_inverse * w);
+    inverse.detach();
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++)
+        inverse.matrix_[i][j] -= correction.matrix_[i][j];
+    }
+    inverse.touch();
+    det *= cap_det;
+  } else {
+    double new_det = 0;
+    Matrix new_inverse(updated.gaussJordanInverse(new_det));
+    if (new_det == 0) throw NonInvertibleError();
+    inverse.replaceMatrix(new_inverse);
+    det = new_det;
+  }
+  replaceMatrix(updated);
+  if (auto lock = lockCache()) {
+    cache_->determinant = det;
+    cache_->has_determinant = true;
+    cache_->inverse = inverse;
+    cache_->has_inverse = true;
+  }
+}
+
+void Matrix::Gemv(const double alpha, const Vector& x, const double beta,
+                  Vector& y) const {
+  if (!matrix_ || !x.getData() || !y.getData()) throw MatrixSetError();
+  if (x.getSize() != cols_ || y.getSize() != rows_)
+    throw DimentionAlignmentError();
+  MatrixService::doubleLegit(alpha);
+  MatrixService::doubleLegit(beta);
+  const double* source = x.getData();
+  MatrixParallel::parallelFor(0, rows_, 2L * cols_, [&](int from, int to) {
+    for (int i = from; i < to; i++) {
+      const double dot = MatrixService::dotProduct(matrix_[i], source, cols_);
+      y[i] = beta == 0 ? alpha * dot : alpha * dot + beta * y[i];
+    }
+  });
+  for (int i = 0; i < rows_; i++) MatrixService::doubleLegit(y[i]);
+}
+
+void Matrix::GemvTransposed(const double alpha, const Vector& x,
+                            const double beta, Vector& y) const {
+  if (!matrix_ || !x.getData() || !y.getData()) throw MatrixSetError();
+  if (x.getSize() != rows_ || y.getSize() != cols_)
+    throw DimentionAlignmentError();
+  MatrixService::doubleLegit(alpha);
+  MatrixService::doubleLegit(beta);
+  const double* source = x.getData();
+  MatrixParallel::parallelFor(0, cols_, 2L * rows_, [&](int from, int to) {
+    for (int j = from; j < to; j++) y[j] = beta == 0 ? 0 : beta * y[j];
+    for (int i = 0; i < rows_; i++) {
+      const double scale = alpha * source[i];
+      const double* row = matrix_[i];
+      for (int j = from; j < to; j++) y[j] += scale * row[j];
+    }
+  });
+  for (int j = 0; j < cols_; j++) MatrixService::doubleLegit(y[j]);
+}
+
+void Matrix::checkSolve(const int rhs_rows, const int max_refinements) const {
+  if (!matrix_) throw MatrixSetError();
+  if (rows_ != cols_) throw SquarenessError();
+  if (rhs_rows != rows_) throw DimentionAlignmentError();
+  if (max_refinements < 0) throw InputError();
+  validateData();
+}
+
+Matrix Matrix::Solve(const Matrix& b, const Precision precision,
+                     const int max_refinements) const {
+  if (!b.matrix_) throw MatrixSetError();
+  checkSolve(b.rows_, max_refinements);
+  b.validateData();
+  Matrix x(rows_, b.cols_);
+  solveInto(b.data_, b.stride_, b.cols_, x.data_, x.stride_, precision,
+            max_refinements);
+  return x;
+}
+
+Vector Matrix::Solve(const Vector& b, const Precision precision,
+                     const int max_refinements) const {
+  if (!b.getData()) throw MatrixSetError();
+  checkSolve(b.getSize(), max_refinements);
+  for (int i = 0; i < b.getSize(); i++) MatrixService::doubleLegit(b[i]);
+  Vector x(rows_);
+  solveInto(b.getData(), 1, 1, &x[0], 1, precision, max_refinements);
+  return x;
+}
+
+Matrix Matrix::InverseMatrix(const Precision precision,
+                             const int max_refinements) const {
+  checkSolve(rows_, max_refinements);
+  Matrix identity(rows_, rows_);
+  for (int i = 0; i < rows_; i++) identity.matrix_[i][i] = 1;
+  Matrix inverse(rows_, rows_);
+  solveInto(identity.data_, identity.stride_, rows_, inverse.data_,
+            inverse.stride_, precision, max_refinements);
+  return inverse;
+}
+
+Matrix Matrix::Pow(const long power) const {
+  checkSolve(rows_, 0);
+  Matrix base(power < 0 ? InverseMatrix(Precision::Double) : *this);
+  Matrix result(rows_, rows_), scratch, storage;
+  if (power == 0) {
+    for (int i = 0; i < rows_; i++) result.matrix_[i][i] = 1;
+    return result;
+  }
+  // Products land in scratch, which then trades storage with its operand.
+  auto keep = [&scratch, &storage](Matrix& target) {
+    storage.replaceMatrix(target);
+    target.replaceMatrix(scratch);
+    scratch.replaceMatrix(storage);
+  };
+  unsigned long exponent = power < 0 ? 0UL - static_cast<unsigned long>(power)
+                                     : static_cast<unsigned long>(power);
+  bool first = true;
+  for (;;) {
+    if (exponent & 1) {
+      if (first) {
+        result = base;
+        first = false;
+      } else {
+        multiplyInto(result, false, base, false, scratch);
+        keep(result);
+      }
+    }
+    exponent >>= 1;
+    if (!exponent) break;
+    multiplyInto(base, false, base, false, scratch);
+    keep(base);
+  }
+  result.validateData();
+  return result;
+}
+
+std::vector<int> Matrix::eliminate(double tolerance, const bool reduced) {
+  if (!matrix_) throw MatrixSetError();
+  validateData();
+  MatrixService::doubleLegit(tolerance);
+  detach();
+  if (tolerance < 0) {
+    tolerance = std::max(rows_, cols_) *
+                std::numeric_limits<double>::epsilon() *
+                Reduce(Reduction::NormInf);
+  }
+  std::vector<int> pivots;
+  int r = 0;
+  for (int col = 0; col < cols_ && r < rows_; col++) {
+    int pivot = r;
+    for (int i = r + 1; i < rows_; i++) {
+      if (fabs(matrix_[i][col]) > fabs(matrix_[pivot][col])) pivot = i;
+    }
+    if (fabs(matrix_[pivot][col]) <= tolerance) {
+      for (int i = r; i < rows_; i++) matrix_[i][col] = 0;
+      continue;
+    }
+    double* pivot_row = matrix_[r];
+    if (pivot != r)
+      std::swap_ranges(matrix_[pivot] + col, matrix_[pivot] + cols_,
+                       pivot_row + col);
+    if (reduced) {
+      const double scale = 1 / pivot_row[col];
+      for (int j = col + 1; j < cols_; j++) pivot_row[j] *= scale;
+      pivot_row[col] = 1;
+    }
+    // Rows are updated independently, so they are split between tasks.
+    const int first = reduced ? 0 : r + 1;
+    MatrixParallel::parallelFor(
+        first, rows_, 2L * (cols_ - col), [&](int from, int to) {
+          for (int i = from; i < to; i++) {
+            double* row = matrix_[i];
+            if (i == r || row[col] == 0) continue;
+            const double factor = row[col] / pivot_row[col];
+            for (int j = col + 1; j < cols_; j++)
+              row[j] -= factor * pivot_row[j];
+            row[col] = 0;
+          }
+        });
+    pivots.push_back(col);
+    r++;
+  }
+  // Rows below the rank only hold values under the tolerance.
+  for (int i = r; i < rows_; i++)
+    std::fill(matrix_[i], matrix_[i] + cols_, 0);
+  touch();
+  return pivots;
+}
+
+int Matrix::Rank(const double tolerance) const {
+  Matrix work(*this);
+  return static_cast<int>(work.eliminate(tolerance, false).size());
+}
+
+Matrix Matrix::RREF(const double tolerance) const {
+  Matrix work(*this);
+  work.eliminate(tolerance, true);
+  return work;
+}
+
+Matrix Matrix::NullSpace(const double tolerance) const {
+  Matrix work(*this);
+  const std::vector<int> pivots = work.eliminate(tolerance, true);
+  const int nullity = cols_ - static_cast<int>(pivots.size());
+  if (!nullity) return Matrix();
+  Matrix basis(cols_, nullity);
+  std::vector<bool> is_pivot(cols_, false);
+  for (const int col : pivots) is_pivot[col] = true;
+  for (int free = 0, k = 0; free < cols_; free++) {
+    if (is_pivot[free]) continue;
+    basis.matrix_[free][k] = 1;
+    for (size_t r = 0; r < pivots.size(); r++)
+      basis.matrix_[pivots[r]][k] = -work.matrix_[r][free];
+    k++;
+  }
+  return basis;
+}
+
+void Matrix::solveInto(const double* b, const int b_stride, const int m,
+                       double* x, const int x_stride,
+                       const Precision precision,
+                       const int max_refinements) const {
+  const int n = rows_;
+  if (precision == Precision::Double && MatrixBlas::accepts(n)) {
+    const BlasLUDecomposition lu(data_, stride_, n);
+    if (lu.isSingular()) throw NonInvertibleError();
+    lu.solve(b, b_stride, m, x, x_stride);
+    return;
+  }
+  std::unique_ptr<LUDecomposition<double>> full;
+  std::unique_ptr<LUDecomposition<float>> low;
+  if (precision == Precision::Mixed)
+    low = std::make_unique<LUDecomposition<float>>(matrix_, n);
+  const double a_norm = low ? normInf() : 0;
+  const double tolerance =
+      std::numeric_limits<double>::epsilon() * std::sqrt(double(n));
+  std::vector<double> column(n), residual(n);
+  std::vector<float> low_column(n);
+
+  for (int col = 0; col < m; col++) {
+    double b_norm = 0;
+    for (int i = 0; i < n; i++) {
+      column[i] = b[static_cast<size_t>(i) * b_stride + col];
+      b_norm = std::max(b_norm, fabs(column[i]));
+    }
+    bool solved = false;
+    if (low && !low->isSingular()) {
+      std::copy(column.begin(), column.end(), low_column.begin());
+      low->solve(low_column.data());
+      std::vector<double> solution(low_column.begin(), low_column.end());
+      double previous = std::numeric_limits<double>::infinity();
+      for (int step = 0; step <= max_refinements; step++) {
+        double r_norm = 0, x_norm = 0;
+        for (int i = 0; i < n; i++) {
+          residual[i] = column[i] - MatrixService::dotProduct(
+                                        matrix_[i], solution.data(), n);
+          r_norm = std::max(r_norm, fabs(residual[i]));
+          x_norm = std::max(x_norm, fabs(solution[i]));
+        }
+        if (!MatrixService::doubleIsLegit(r_norm + x_norm)) break;
+        if (r_norm <= tolerance * (a_norm * x_norm + b_norm)) {
+          solved = true;
+          std::copy(solution.begin(), solution.end(), column.begin());
+          break;
+        }
+        if (step == max_refinements) break;
+        std::copy(residual.begin(), residual.end(), low_column.begin());
+        low->solve(low_column.data());
+        double correction = 0;
+        for (int i = 0; i < n; i++) {
+          correction = std::max(correction, double(fabs(low_column[i])));
+          solution[i] += low_column[i];
+        }
+        if (!(correction <= 0.5 * previous)) break;
+        previous = correction;
+      }
+    }
+    if (!solved) {
+      if (!full) {
+        full = std::make_unique<LUDecomposition<double>>(matrix_, n);
+        if (full->isSingular()) throw NonInvertibleError();
+      }
+      full->solve(column.data());
+    }
+    for (int i = 0; i < n; i++)
+      x[static_cast<size_t>(i) * x_stride + col] = column[i];
+  }
 }
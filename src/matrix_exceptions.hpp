@@ -1,5 +1,26 @@
 #ifndef MATRIX_EXCEPTIONS
 #define MATRIX_EXCEPTIONS
+#include <exception>
+#include <string>
+
+/**
+ * @brief Error codes reported by the non-throwing ("try") methods.
+ * @note Every code except Ok matches the exception class of the same name.
+ */
+enum class MatrixStatus {
+  Ok,
+  UnknownError,
+  DimentionError,
+  DataError,
+  DimentionEqualityError,
+  DimentionAlignmentError,
+  MemoryAllocationError,
+  OutOfRangeError,
+  MatrixSetError,
+  SquarenessError,
+  NonInvertibleError,
+  InputError
+};
 
 /**
  * @brief Base class for matrix-related exceptions.
@@ -27,6 +48,13 @@ class MatrixError : public std::exception {
    * @return A C-string representing the error message.
    */
   const char* what() const noexcept override { return msg.c_str(); }
+  /**
+   * @brief Provides the error code matching the exception.
+   * @return The error code.
+   */
+  virtual MatrixStatus status() const noexcept {
+    return MatrixStatus::UnknownError;
+  }
 };
 
 /**
@@ -41,6 +69,9 @@ class DimentionError : public MatrixError {
       const char* error =
           "Matrix sizes error: matrix dimensions should be positive.")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::DimentionError;
+  }
 };
 
 /**
@@ -55,6 +86,9 @@ class DataError : public MatrixError {
                 "Incorrect data: impossible to input/calculate due to data "
                 "error (inf, nan, etc).")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::DataError;
+  }
 };
 
 /**
@@ -69,6 +103,9 @@ class DimentionEqualityError : public MatrixError {
       const char* error =
           "Calculation impossible: matrices' dimensions are not equal.")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::DimentionEqualityError;
+  }
 };
 
 /**
@@ -84,6 +121,9 @@ class DimentionAlignmentError : public MatrixError {
           "Calculation impossible: the number of columns of the first matrix "
           "does not equal the number of rows of the second matrix.")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::DimentionAlignmentError;
+  }
 };
 
 /**
@@ -98,6 +138,9 @@ class MemoryAllocationError : public MatrixError {
       const char* error =
           "Memory allocation problem: congratulations, you got it somehow!")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::MemoryAllocationError;
+  }
 };
 
 /**
@@ -112,6 +155,9 @@ class OutOfRangeError : public MatrixError {
                       "Out of range error: you are trying to reach an element "
                       "out of matrix bounds.")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::OutOfRangeError;
+  }
 };
 
 /**
@@ -124,6 +170,9 @@ class MatrixSetError : public MatrixError {
  public:
   MatrixSetError(const char* error = "Matrix not set or does not exist.")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::MatrixSetError;
+  }
 };
 
 /**
@@ -136,6 +185,9 @@ class SquarenessError : public MatrixError {
  public:
   SquarenessError(const char* error = "The matrix is not square")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::SquarenessError;
+  }
 };
 
 /**
@@ -150,6 +202,9 @@ class NonInvertibleError : public MatrixError {
       const char* error =
           "The matrix is not invertible: the determinant is zero.")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::NonInvertibleError;
+  }
 };
 
 /**
@@ -162,6 +217,42 @@ class InputError : public MatrixError {
  public:
   InputError(const char* error = "Input parameter or data error.")
       : MatrixError(error) {}
+  MatrixStatus status() const noexcept override {
+    return MatrixStatus::InputError;
+  }
 };
 
+/**
+ * @brief Throws the exception matching an error code of the "try" methods.
+ * @param status The error code (nothing is thrown for MatrixStatus::Ok).
+ */
+inline void throwMatrixStatus(const MatrixStatus status) {
+  switch (status) {
+    case MatrixStatus::Ok:
+      return;
+    case MatrixStatus::DimentionError:
+      throw DimentionError();
+    case MatrixStatus::DataError:
+      throw DataError();
+    case MatrixStatus::DimentionEqualityError:
+      throw DimentionEqualityError();
+    case MatrixStatus::DimentionAlignmentError:
+      throw DimentionAlignmentError();
+    case MatrixStatus::MemoryAllocationError:
+      throw MemoryAllocationError();
+    case MatrixStatus::OutOfRangeError:
+      throw OutOfRangeError();
+    case MatrixStatus::MatrixSetError:
+      throw MatrixSetError();
+    case MatrixStatus::SquarenessError:
+      throw SquarenessError();
+    case MatrixStatus::NonInvertibleError:
+      throw NonInvertibleError();
+    case MatrixStatus::InputError:
+      throw InputError();
+    default:
+      throw MatrixError();
+  }
+}
+
 #endif  // MATRIX_EXCEPTIONS
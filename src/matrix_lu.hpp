@@ -0,0 +1,117 @@
+#ifndef MATRIX_LU
+#define MATRIX_LU
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief LU decomposition with partial pivoting (P * A = L * U) of a square
+ * matrix, computed in the precision T.
+ * @tparam T The precision of the factors (float or double).
+ * @note Used by the solvers of the library; the input is always read as
+ * doubles through a row table (one pointer per row, as Matrix keeps them).
+ */
+template <typename T>
+class LUDecomposition {
+ private:
+  int n_{0};                 ///< Order of the matrix.
+  std::vector<T> lu_;        ///< Both factors packed row by row (L has a unit
+                             ///< diagonal that is not stored).
+  std::vector<int> pivots_;  ///< Row swapped with each row while eliminating.
+  int sign_{1};              ///< Sign of the permutation.
+  bool singular_{false};     ///< Whether a zero or non-finite pivot was met.
+
+ public:
+  /**
+   * @brief Factorizes a square matrix.
+   * @param rows The row table of the matrix (n pointers to n doubles).
+   * @param n The order of the matrix.
+   */
+  LUDecomposition(const double* const* rows, const int n)
+      : n_(n), lu_(static_cast<std::size_t>(n) * n), pivots_(n) {
+    for (int i = 0; i < n_; i++)
+      std::copy(rows[i], rows[i] + n_, row(i));
+    for (int k = 0; k < n_ && !singular_; k++) {
+      int pivot = k;
+      for (int i = k + 1; i < n_; i++) {
+        if (std::fabs(at(i, k)) > std::fabs(at(pivot, k))) pivot = i;
+      }
+      pivots_[k] = pivot;
+      if (at(pivot, k) == T(0) || !std::isfinite(at(pivot, k))) {
+        singular_ = true;
+        break;
+      }
+      if (pivot != k) {
+        std::swap_ranges(row(pivot), row(pivot) + n_, row(k));
+        sign_ = -sign_;
+      }
+      const T* pivot_row = row(k);
+      for (int i = k + 1; i < n_; i++) {
+        T* current = row(i);
+        const T factor = current[k] /= pivot_row[k];
+        for (int j = k + 1; j < n_; j++) current[j] -= factor * pivot_row[j];
+      }
+    }
+  }
+  /**
+   * @brief Checks if the matrix was found singular (in the precision T).
+   * @return True if the factors can not be used to solve systems.
+   */
+  bool isSingular() const noexcept { return singular_; }
+  /**
+   * @brief Calculates the determinant from the factors.
+   * @return The determinant (zero if the matrix is singular).
+   */
+  double determinant() const noexcept {
+    if (singular_) return 0;
+    double det = sign_;
+    for (int i = 0; i < n_; i++) det *= at(i, i);
+    return det;
+  }
+  /**
+   * @brief Solves A * x = b in place.
+   * @param x The right hand side on entry, the solution on exit (n elements).
+   */
+  void solve(T* x) const noexcept {
+    for (int k = 0; k < n_; k++) std::swap(x[k], x[pivots_[k]]);
+    for (int i = 1; i < n_; i++) {
+      const T* current = row(i);
+      T sum = x[i];
+      for (int j = 0; j < i; j++) sum -= current[j] * x[j];
+      x[i] = sum;
+    }
+    for (int i = n_ - 1; i >= 0; i--) {
+      const T* current = row(i);
+      T sum = x[i];
+      for (int j = i + 1; j < n_; j++) sum -= current[j] * x[j];
+      x[i] = sum / current[i];
+    }
+  }
+
+ private:
+  /**
+   * @brief Retrieves a row of the packed factors.
+   * @param i Row index.
+   * @return Pointer to the first element of the row.
+   */
+  T* row(const int i) noexcept {
+    return lu_.data() + static_cast<std::size_t>(i) * n_;
+  }
+  /**
+   * @brief Retrieves a constant row of the packed factors.
+   * @param i Row index.
+   * @return Constant pointer to the first element of the row.
+   */
+  const T* row(const int i) const noexcept {
+    return lu_.data() + static_cast<std::size_t>(i) * n_;
+  }
+  /**
+   * @brief Retrieves an element of the packed factors.
+   * @param i Row index.
+   * @param j Column index.
+   * @return The value of the element.
+   */
+  T at(const int i, const int j) const noexcept { return row(i)[j]; }
+};
+#endif  // MATRIX_LU
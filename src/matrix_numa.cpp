@@ -0,0 +1,310 @@
+#include "matrix_numa.hpp"
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "matrix_parallel.hpp"
+#include "matrix_scheduler.hpp"
+#include "matrix_service.hpp"
+
+// Interleave mode of the mbind system call (MPOL_INTERLEAVE of <numaif.h>).
+static constexpr int NUMA_INTERLEAVE_MODE = 3;
+// Size of the memory pages placed by the memory policy.
+static constexpr std::size_t NUMA_PAGE = 4096;
+// Largest NUMA node index handled.
+static constexpr int NUMA_MAX_NODES = 1024;
+// Bytes in front of every block holding the size of its mapping (zero for
+// blocks of the heap).
+static constexpr std::size_t NUMA_PREFIX = MEMORY_ALIGNMENT;
+
+/**
+ * @brief The NUMA nodes and the CPUs available to the process.
+ */
+struct NumaTopology {
+  std::vector<int> nodes;  ///< Indices of the online nodes.
+  std::vector<int> cpus;   ///< Allowed CPUs, alternating between the nodes.
+};
+
+/**
+ * @brief Parses a list such as "0-3,8,10-11".
+ * @param list The list.
+ * @return The listed numbers.
+ */
+static std::vector<int> parseList(const std::string& list) {
+  std::vector<int> numbers;
+  size_t position = 0;
+  while (position < list.size()) {
+    size_t end = list.find(',', position);
+    if (end == std::string::npos) end = list.size();
+    const std::string range = list.substr(position, end - position);
+    const size_t dash = range.find('-');
+    try {
+      const int first = std::stoi(range);
+      const int last =
+          dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int number = first; number <= last; number++)
+        numbers.push_back(number);
+    } catch (...) {
+    }
+    position = end + 1;
+  }
+  return numbers;
+}
+
+/**
+ * @brief Reads the first line of a system file.
+ * @param path The file.
+ * @return The line (empty if the file can not be read).
+ */
+static std::string readLine(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+/**
+ * @brief Detects the topology once (before any thread is pinned).
+ * @return The topology, never destroyed: the workers of the shared scheduler
+ * may pin themselves while static objects are destroyed at exit.
+ */
+static const NumaTopology& topology() {
+  static const NumaTopology* detected = new NumaTopology([] {
+    NumaTopology result;
+    std::vector<int> allowed;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) allowed.push_back(cpu);
+      }
+    }
+#endif
+    const std::string root = "/sys/devices/system/node/";
+    for (int node : parseList(readLine(root + "online"))) {
+      if (node < NUMA_MAX_NODES) result.nodes.push_back(node);
+    }
+    std::vector<std::vector<int>> by_node;
+    for (int node : result.nodes) {
+      std::vector<int> cpus;
+      for (int cpu : parseList(readLine(root + "node" + std::to_string(node) +
+                                        "/cpulist"))) {
+        if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+          cpus.push_back(cpu);
+      }
+      if (!cpus.empty()) by_node.push_back(cpus);
+    }
+    for (size_t k = 0; result.cpus.size() < allowed.size(); k++) {
+      const size_t before = result.cpus.size();
+      for (const std::vector<int>& cpus : by_node) {
+        if (k < cpus.size()) result.cpus.push_back(cpus[k]);
+      }
+      if (result.cpus.size() == before) break;
+    }
+    if (result.cpus.size() != allowed.size()) result.cpus = allowed;
+    return result;
+  }());
+  return *detected;
+}
+
+/**
+ * @brief Reads the initial memory policy from the environment.
+ * @return The policy.
+ */
+static MemoryPolicy initialPolicy() noexcept {
+  const char* value = std::getenv("MATRIX_MEMORY_POLICY");
+  if (value && !std::strcmp(value, "first-touch"))
+    return MemoryPolicy::FirstTouch;
+  if (value && !std::strcmp(value, "interleave"))
+    return MemoryPolicy::Interleave;
+  return MemoryPolicy::Local;
+}
+
+/**
+ * @brief Retrieves the current memory policy.
+ * @return Reference to the policy.
+ */
+static std::atomic<MemoryPolicy>& currentPolicy() noexcept {
+  static std::atomic<MemoryPolicy> policy(initialPolicy());
+  return policy;
+}
+
+/**
+ * @brief Spreads the whole pages of a memory range over all NUMA nodes.
+ * @param memory The start of the range.
+ * @param bytes The size of the range.
+ */
+static void interleavePages(void* memory, const std::size_t bytes) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+  try {
+    const NumaTopology& numa = topology();
+    if (numa.nodes.size() < 2) return;
+    unsigned long mask[NUMA_MAX_NODES / (8 * sizeof(unsigned long))] = {};
+    for (int node : numa.nodes)
+      mask[node / (8 * sizeof(unsigned long))] |=
+          1UL << (node % (8 * sizeof(unsigned long)));
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(memory);
+    const std::uintptr_t first = (start + NUMA_PAGE - 1) / NUMA_PAGE * NUMA_PAGE;
+    const std::uintptr_t last = (start + bytes) / NUMA_PAGE * NUMA_PAGE;
+    // The kernel reads maxnode - 1 bits of the mask (as libnuma, pass one
+    // more than the bits used).
+    if (last > first)
+      syscall(SYS_mbind, first, last - first, NUMA_INTERLEAVE_MODE, mask,
+              NUMA_MAX_NODES + 1, 0);
+  } catch (...) {
+  }
+#else
+  (void)memory;
+  (void)bytes;
+#endif
+}
+
+/**
+ * @brief Zero fills a fresh mapping with the row partition of
+ * MatrixParallel::parallelFor, so every page is first written by the thread
+ * that runs its chunk of the kernels.
+ * @param mapping The start of the mapping (the storage follows NUMA_PREFIX).
+ * @param mapped The size of the mapping.
+ * @param bytes The size of the storage.
+ * @param rows The number of equal rows of the storage.
+ */
+static void touchPages(char* mapping, const std::size_t mapped,
+                       const std::size_t bytes, const int rows) noexcept {
+  const int threads = std::min(MatrixParallel::threadCount(), rows);
+  const int chunk = (rows + threads - 1) / threads;
+  MatrixScheduler* pool = nullptr;
+  std::vector<std::size_t> bounds;
+  try {
+    pool = &MatrixScheduler::instance();
+    pool->pinWorkers();
+    bounds.assign(threads + 1, mapped);
+  } catch (...) {
+    std::memset(mapping, 0, mapped);
+    return;
+  }
+  MatrixScheduler& scheduler = *pool;
+  // Chunk t owns the pages starting within its rows.
+  bounds[0] = 0;
+  for (int t = 1; t < threads; t++) {
+    const std::size_t start =
+        NUMA_PREFIX + bytes / rows * std::min(rows, t * chunk);
+    bounds[t] =
+        std::min(mapped, (start + NUMA_PAGE - 1) / NUMA_PAGE * NUMA_PAGE);
+  }
+  auto touch = [mapping, &bounds](const int t) {
+    std::memset(mapping + bounds[t], 0, bounds[t + 1] - bounds[t]);
+  };
+  std::atomic<int> remaining(0);
+  for (int t = 1; t < threads; t++) {
+    if (bounds[t] == bounds[t + 1]) continue;
+    try {
+      remaining++;
+      scheduler.pushBound(t, [&touch, &remaining, t]() {
+        touch(t);
+        remaining--;
+      });
+    } catch (...) {
+      remaining--;
+      touch(t);
+    }
+  }
+  touch(0);
+  while (remaining > 0) {
+    try {
+      if (scheduler.runPending()) continue;
+    } catch (...) {
+    }
+    std::this_thread::yield();
+  }
+}
+
+void MatrixNuma::setMemoryPolicy(const MemoryPolicy policy) noexcept {
+  currentPolicy() = policy;
+}
+
+MemoryPolicy MatrixNuma::getMemoryPolicy() noexcept { return currentPolicy(); }
+
+int MatrixNuma::nodeCount() noexcept {
+  try {
+    return std::max(1, static_cast<int>(topology().nodes.size()));
+  } catch (...) {
+    return 1;
+  }
+}
+
+double* MatrixNuma::allocate(const std::size_t count,
+                             const int rows) noexcept {
+  const std::size_t bytes = (count ? count : 1) * sizeof(double);
+  const MemoryPolicy policy =
+      bytes < NUMA_MIN_BYTES ? MemoryPolicy::Local : getMemoryPolicy();
+#if defined(MAP_ANONYMOUS)
+  if (policy != MemoryPolicy::Local) {
+    // The heap may hand out pages another thread or policy faulted already,
+    // so the policy only places pages mapped for this block.
+    const std::size_t mapped =
+        (NUMA_PREFIX + bytes + NUMA_PAGE - 1) / NUMA_PAGE * NUMA_PAGE;
+    void* mapping = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return nullptr;
+    char* base = static_cast<char*>(mapping);
+    if (policy == MemoryPolicy::Interleave)
+      interleavePages(base, mapped);
+    else
+      touchPages(base, mapped, bytes, std::max(rows, 1));
+    std::memcpy(base, &mapped, sizeof(mapped));
+    return reinterpret_cast<double*>(base + NUMA_PREFIX);
+  }
+#endif
+  void* memory = ::operator new[](NUMA_PREFIX + bytes,
+                                  std::align_val_t{MEMORY_ALIGNMENT},
+                                  std::nothrow);
+  if (!memory) return nullptr;
+  // A zero prefix marks a block of the heap.
+  std::memset(memory, 0, NUMA_PREFIX + bytes);
+  return reinterpret_cast<double*>(static_cast<char*>(memory) + NUMA_PREFIX);
+}
+
+void MatrixNuma::deallocate(double* memory) noexcept {
+  if (!memory) return;
+  char* base = reinterpret_cast<char*>(memory) - NUMA_PREFIX;
+  std::size_t mapped = 0;
+  std::memcpy(&mapped, base, sizeof(mapped));
+#if defined(MAP_ANONYMOUS)
+  if (mapped) {
+    munmap(base, mapped);
+    return;
+  }
+#endif
+  ::operator delete[](base, std::align_val_t{MEMORY_ALIGNMENT});
+}
+
+bool MatrixNuma::pinThread(const int index) noexcept {
+#if defined(__linux__)
+  try {
+    const std::vector<int>& cpus = topology().cpus;
+    if (cpus.empty() || index < 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[index % cpus.size()], &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+  } catch (...) {
+    return false;
+  }
+#else
+  (void)index;
+  return false;
+#endif
+}
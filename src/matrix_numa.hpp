@@ -0,0 +1,68 @@
+#ifndef MATRIX_NUMA
+#define MATRIX_NUMA
+#include <cstddef>
+
+// Allocations below this size (in bytes) ignore the NUMA memory policy.
+constexpr std::size_t NUMA_MIN_BYTES(1 << 20);
+
+/**
+ * @brief Placement of the pages of large matrix and vector storage.
+ */
+enum class MemoryPolicy {
+  Local,       ///< Zero filled by the allocating thread (its NUMA node).
+  FirstTouch,  ///< Zero filled in parallel by the pinned scheduler workers.
+              ///< Each worker fills the rows its parallel loop chunk covers.
+  Interleave   ///< Pages spread round robin over all NUMA nodes.
+};
+
+/**
+ * @brief Provides NUMA aware storage allocation and thread placement.
+ * @details The initial memory policy is read from the MATRIX_MEMORY_POLICY
+ * environment variable ("local", "first-touch" or "interleave"). Placement
+ * requests the system does not support are ignored.
+ */
+namespace MatrixNuma {
+  /**
+   * @brief Sets the memory policy of subsequent allocations.
+   * @param policy The policy.
+   */
+  void setMemoryPolicy(const MemoryPolicy policy) noexcept;
+  /**
+   * @brief Retrieves the memory policy.
+   * @return The policy.
+   */
+  MemoryPolicy getMemoryPolicy() noexcept;
+  /**
+   * @brief Retrieves the number of NUMA nodes of the system.
+   * @return Amount of nodes (at least one).
+   */
+  int nodeCount() noexcept;
+  /**
+   * @brief Allocates zero filled storage aligned to MEMORY_ALIGNMENT, placing
+   * its pages according to the memory policy.
+   * @details Storage following a policy other than MemoryPolicy::Local is
+   * mapped fresh from the system, so none of its pages were faulted before.
+   * Under MemoryPolicy::FirstTouch the rows are split into the chunks
+   * MatrixParallel::parallelFor uses at full width: the caller fills the first
+   * one and worker t of the shared scheduler, which gets pinned, fills chunk t.
+   * @param count The number of doubles to allocate.
+   * @param rows The number of equal rows the kernels split the storage into.
+   * @return Pointer to the storage (freed by deallocate()) or nullptr if the
+   * allocation failed.
+   */
+  double* allocate(const std::size_t count, const int rows = 1) noexcept;
+  /**
+   * @brief Frees storage allocated by allocate().
+   * @param memory Pointer to the storage (may be nullptr).
+   */
+  void deallocate(double* memory) noexcept;
+  /**
+   * @brief Pins the calling thread to one CPU.
+   * @details CPUs are taken in an order alternating between the NUMA nodes,
+   * so consecutive indices are spread over all the sockets.
+   * @param index The index of the thread (wraps around the CPU count).
+   * @return True if the thread was pinned.
+   */
+  bool pinThread(const int index) noexcept;
+}
+#endif  // MATRIX_NUMA
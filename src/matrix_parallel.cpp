@@ -0,0 +1,24 @@
+#include "matrix_parallel.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief Retrieves the deterministic reductions switch.
+ * @return Reference to the switch.
+ */
+static std::atomic<bool>& deterministicFlag() noexcept {
+  static std::atomic<bool> flag([] {
+    const char* value = std::getenv("MATRIX_DETERMINISTIC");
+    return value && std::strcmp(value, "0");
+  }());
+  return flag;
+}
+
+bool MatrixParallel::isDeterministic() noexcept {
+  return deterministicFlag();
+}
+
+void MatrixParallel::setDeterministic(const bool enabled) noexcept {
+  deterministicFlag() = enabled;
+}
@@ -0,0 +1,134 @@
+#include "matrix_scheduler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "matrix_numa.hpp"
+
+static thread_local const MatrixScheduler* current_scheduler = nullptr;
+static thread_local int current_worker = -1;
+
+MatrixScheduler::MatrixScheduler(const int workers, const bool pinned)
+    : pinned_(pinned) {
+  const int count = std::max(1, workers);
+  for (int i = 0; i < count; i++) queues_.push_back(std::make_unique<Queue>());
+  for (int i = 0; i < count; i++)
+    threads_.emplace_back([this, i]() { workerLoop(i); });
+}
+
+MatrixScheduler::~MatrixScheduler() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& thread : threads_) thread.join();
+}
+
+MatrixScheduler& MatrixScheduler::instance() {
+  static MatrixScheduler scheduler(
+      static_cast<int>(std::thread::hardware_concurrency()), [] {
+        const char* pin = std::getenv("MATRIX_PIN_THREADS");
+        return pin && std::strcmp(pin, "0");
+      }());
+  return scheduler;
+}
+
+int MatrixScheduler::currentWorker() const noexcept {
+  return current_scheduler == this ? current_worker : -1;
+}
+
+void MatrixScheduler::pinWorkers() {
+  if (pinned_.exchange(true)) return;
+  for (int i = 0; i < getWorkers(); i++)
+    pushBound(i, [i]() { MatrixNuma::pinThread(i); });
+}
+
+void MatrixScheduler::push(Task task, const int worker) {
+  int index = currentWorker();
+  if (index < 0 && worker >= 0) index = worker % queues_.size();
+  if (index < 0) index = next_queue_++ % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    pending_++;
+  }
+  wake_.notify_one();
+}
+
+void MatrixScheduler::pushBound(const int worker, Task task) {
+  Queue& queue = *queues_[worker % queues_.size()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.bound.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    queue.bound_pending++;
+  }
+  // The worker is not known to the condition, so every sleeper checks.
+  wake_.notify_all();
+}
+
+bool MatrixScheduler::takeTask(const int own, Task& task) {
+  if (own >= 0 && queues_[own]->bound_pending.load() > 0) {
+    Queue& queue = *queues_[own];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    task = std::move(queue.bound.front());
+    queue.bound.pop_front();
+    queue.bound_pending--;
+    return true;
+  }
+  if (pending_.load() <= 0) return false;
+  if (own >= 0) {
+    Queue& queue = *queues_[own];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      pending_--;
+      return true;
+    }
+  }
+  const int count = static_cast<int>(queues_.size());
+  const int start = own >= 0 ? own + 1 : 0;
+  for (int k = 0; k < count; k++) {
+    Queue& queue = *queues_[(start + k) % count];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      pending_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MatrixScheduler::runPending() {
+  Task task;
+  if (!takeTask(currentWorker(), task)) return false;
+  task();
+  return true;
+}
+
+void MatrixScheduler::workerLoop(const int index) {
+  current_scheduler = this;
+  current_worker = index;
+  if (pinned_) MatrixNuma::pinThread(index);
+  while (!stop_) {
+    Task task;
+    if (takeTask(index, task)) {
+      task();
+    } else {
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [this, index]() {
+        return stop_ || pending_ > 0 || queues_[index]->bound_pending > 0;
+      });
+    }
+  }
+}
@@ -1,6 +1,9 @@
 #ifndef MATRIX_SERVICE
 #define MATRIX_SERVICE
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 #include "matrix_exceptions.hpp"
 
@@ -10,6 +13,35 @@ using std::isinf, std::isnan;
 constexpr double DOUBLE_ZERO(0);
 // Defines a small margin of error for floating-point comparisons.
 constexpr double EPSILON(1e-7);
+// Reciprocal condition number below which low-rank updates are recomputed.
+constexpr double UPDATE_RCOND_LIMIT(1e-12);
+// Tile size (in elements) of the cache blocked transpose.
+constexpr int TRANSPOSE_BLOCK(32);
+// Depth (in elements) of the panels of the blocked matrix product.
+constexpr int MULTIPLY_BLOCK(256);
+// Minimal amount of scalar operations that justifies an extra thread.
+constexpr long PARALLEL_GRAIN(1L << 16);
+// Order from which products and factorizations use the BLAS backend.
+constexpr int BLAS_ORDER(64);
+// Elements per partial result of the reductions in deterministic mode.
+constexpr int REDUCTION_BLOCK(4096);
+// Order up to which determinants and inverses are computed from cofactors
+// (exact for small integer matrices), larger ones use the LU decomposition.
+constexpr int COFACTOR_ORDER(3);
+// Default limit of iterative refinement steps of the mixed precision solvers.
+constexpr int MAX_REFINEMENTS(10);
+// Alignment (in bytes) of matrix and vector storage: one cache line.
+constexpr std::size_t MEMORY_ALIGNMENT(64);
+// Doubles in front of matrix storage holding its reference count (one line).
+constexpr int STORAGE_HEADER(MEMORY_ALIGNMENT / sizeof(double));
+// Elements (row padding included) a matrix stores inside the object itself.
+constexpr int INLINE_ELEMENTS(16);
+// Row size (in bytes) that makes consecutive rows share cache sets.
+constexpr std::size_t CACHE_ALIASING_STRIDE(4096);
+// Default order of the square tiles of file backed matrices.
+constexpr int TILE_SIZE(256);
+// Default number of tiles a file backed matrix keeps in memory.
+constexpr int TILE_CACHE(64);
 
 /**
  * @brief Provides utility methods for matrix-related operations, including
@@ -50,5 +82,70 @@ namespace MatrixService {
   inline static void doubleLegit(const double& a) {
     if (isnan(a) || isinf(a)) throw DataError();
   }
+  /**
+   * @brief Checks a double value, without throwing, to be neither NaN nor
+   * infinite.
+   * @param a The double value to check.
+   * @return True if the value is finite, false otherwise.
+   */
+  inline static bool doubleIsLegit(const double& a) noexcept {
+    return !(isnan(a) || isinf(a));
+  }
+  /**
+   * @brief Calculates the dot product of two contiguous arrays.
+   * @details Uses four independent accumulators so that the loop vectorizes
+   * without reassociating floating-point math.
+   * @param a The first array.
+   * @param b The second array.
+   * @param n The number of elements in the arrays.
+   * @return The dot product.
+   */
+  inline static double dotProduct(const double* a, const double* b,
+                                  const int n) noexcept {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int i = 0;
+    for (; i + 3 < n; i += 4) {
+      s0 += a[i] * b[i];
+      s1 += a[i + 1] * b[i + 1];
+      s2 += a[i + 2] * b[i + 2];
+      s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+  }
+  /**
+   * @brief Calculates the padded distance between rows (leading dimension).
+   * @details Rows longer than half a cache line are padded to whole cache
+   * lines, so every row starts on a cache line boundary. Strides of a
+   * multiple of CACHE_ALIASING_STRIDE bytes get one more cache line to avoid
+   * cache set aliasing. Shorter rows are padded to a power of two so they
+   * never straddle cache lines.
+   * @param cols The number of columns to hold.
+   * @return The stride in elements.
+   */
+  inline static int paddedStride(const int cols) noexcept {
+    constexpr int line = MEMORY_ALIGNMENT / sizeof(double);
+    if (cols <= line / 2) {
+      int stride = 1;
+      while (stride < cols) stride *= 2;
+      return stride;
+    }
+    int stride = (cols + line - 1) / line * line;
+    if ((stride * sizeof(double)) % CACHE_ALIASING_STRIDE == 0) stride += line;
+    return stride;
+  }
+  /**
+   * @brief Mixes the bit pattern of a double value into a hash state.
+   * @param state The current hash state.
+   * @param value The value to mix in.
+   * @return The new hash state.
+   */
+  inline static std::uint64_t hashMix(std::uint64_t state,
+                                      const double value) noexcept {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    state = (state ^ bits) * 0xFF51AFD7ED558CCDULL;
+    return state ^ (state >> 32);
+  }
 }
 #endif  // MATRIX_SERVICE
\ No newline at end of file
@@ -0,0 +1,656 @@
+#include "matrix_structured.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "matrix_lu.hpp"
+#include "matrix_parallel.hpp"
+
+PackedMatrix::PackedMatrix(const int size, const size_t packed) {
+  if (size <= 0) throw DimentionError();
+  size_ = size;
+  data_.assign(packed, 0);
+}
+
+void PackedMatrix::checkIndex(const int row, const int col) const {
+  if (row < 0 || col < 0 || row >= size_ || col >= size_)
+    throw OutOfRangeError();
+}
+
+int PackedMatrix::squareOrder(const Matrix& matrix) {
+  if (!matrix.getMatrix()) throw MatrixSetError();
+  if (matrix.getRows() != matrix.getCols()) throw SquarenessError();
+  return matrix.getRows();
+}
+
+std::vector<double> PackedMatrix::readSquare(const Matrix& matrix) {
+  const int n = squareOrder(matrix);
+  std::vector<double> dense(static_cast<size_t>(n) * n);
+  const double** rows = matrix.getMatrix();
+  for (int i = 0; i < n; i++)
+    std::copy(rows[i], rows[i] + n,
+              dense.begin() + static_cast<size_t>(i) * n);
+  for (double value : dense) MatrixService::doubleLegit(value);
+  return dense;
+}
+
+std::vector<double> PackedMatrix::readOperand(const Matrix& matrix) const {
+  if (!matrix.getMatrix()) throw MatrixSetError();
+  if (matrix.getRows() != size_) throw DimentionAlignmentError();
+  const int m = matrix.getCols();
+  std::vector<double> dense(static_cast<size_t>(size_) * m);
+  const double** rows = matrix.getMatrix();
+  for (int i = 0; i < size_; i++)
+    std::copy(rows[i], rows[i] + m,
+              dense.begin() + static_cast<size_t>(i) * m);
+  for (double value : dense) MatrixService::doubleLegit(value);
+  return dense;
+}
+
+std::vector<double> PackedMatrix::readOperand(const Vector& vector) const {
+  if (!vector.getData()) throw MatrixSetError();
+  if (vector.getSize() != size_) throw DimentionAlignmentError();
+  std::vector<double> dense(vector.getData(), vector.getData() + size_);
+  for (double value : dense) MatrixService::doubleLegit(value);
+  return dense;
+}
+
+template <typename RowProduct>
+Matrix PackedMatrix::multiplyRows(const Matrix& b,
+                                  RowProduct&& row_product) const {
+  const std::vector<double> dense = readOperand(b);
+  const int m = b.getCols();
+  std::vector<double> result(dense.size(), 0);
+  MatrixParallel::parallelFor(
+      0, size_, 2L * m * std::max(1L, getPackedSize() / size_),
+      [&](int from, int to) {
+        for (int i = from; i < to; i++)
+          row_product(i, dense.data(), m,
+                      result.data() + static_cast<size_t>(i) * m);
+      });
+  return Matrix(size_, m, size_ * m, result.data());
+}
+
+template <typename Solve>
+Matrix PackedMatrix::solveColumns(const Matrix& b, Solve&& solve) const {
+  std::vector<double> dense = readOperand(b);
+  const int m = b.getCols();
+  std::vector<double> column(size_);
+  for (int j = 0; j < m; j++) {
+    for (int i = 0; i < size_; i++)
+      column[i] = dense[static_cast<size_t>(i) * m + j];
+    solve(column.data());
+    for (int i = 0; i < size_; i++)
+      dense[static_cast<size_t>(i) * m + j] = column[i];
+  }
+  return Matrix(size_, m, size_ * m, dense.data());
+}
+
+template <typename Solve>
+Vector PackedMatrix::solveVector(const Vector& b, Solve&& solve) const {
+  std::vector<double> x = readOperand(b);
+  solve(x.data());
+  return Vector(size_, size_, x.data());
+}
+
+// DiagonalMatrix
+
+DiagonalMatrix::DiagonalMatrix(const int size, const int n,
+                               const double diagonal[])
+    : DiagonalMatrix(size) {
+  if (n < 0 || !diagonal) throw InputError();
+  if (n > size_) throw OutOfRangeError();
+  for (int i = 0; i < n; i++) MatrixService::doubleLegit(diagonal[i]);
+  std::copy(diagonal, diagonal + n, data_.begin());
+}
+
+DiagonalMatrix::DiagonalMatrix(const Matrix& matrix)
+    : DiagonalMatrix(squareOrder(matrix)) {
+  const std::vector<double> dense = readSquare(matrix);
+  for (int i = 0; i < size_; i++) {
+    for (int j = 0; j < size_; j++) {
+      const double value = dense[static_cast<size_t>(i) * size_ + j];
+      if (i == j)
+        data_[i] = value;
+      else if (value != 0)
+        throw InputError();
+    }
+  }
+}
+
+double DiagonalMatrix::getElement(const int row, const int col) const {
+  checkIndex(row, col);
+  return row == col ? data_[row] : 0;
+}
+
+void DiagonalMatrix::setElement(const int row, const int col,
+                                const double value) {
+  checkIndex(row, col);
+  if (row != col) throw OutOfRangeError();
+  MatrixService::doubleLegit(value);
+  data_[row] = value;
+}
+
+DiagonalMatrix::operator Matrix() const {
+  Matrix result(size_, size_);
+  for (int i = 0; i < size_; i++) result(i, i) = data_[i];
+  return result;
+}
+
+Matrix DiagonalMatrix::operator*(const Matrix& other) const {
+  return multiplyRows(other, [this](int i, const double* b, int m,
+                                    double* c) {
+    const double* b_row = b + static_cast<size_t>(i) * m;
+    for (int j = 0; j < m; j++) c[j] = data_[i] * b_row[j];
+  });
+}
+
+Vector DiagonalMatrix::operator*(const Vector& x) const {
+  std::vector<double> y = readOperand(x);
+  for (int i = 0; i < size_; i++) y[i] *= data_[i];
+  return Vector(size_, size_, y.data());
+}
+
+void DiagonalMatrix::solveInPlace(double* x) const {
+  for (int i = 0; i < size_; i++) x[i] /= data_[i];
+}
+
+Matrix DiagonalMatrix::Solve(const Matrix& b) const {
+  if (Determinant() == 0) throw NonInvertibleError();
+  return solveColumns(b, [this](double* x) { solveInPlace(x); });
+}
+
+Vector DiagonalMatrix::Solve(const Vector& b) const {
+  if (Determinant() == 0) throw NonInvertibleError();
+  return solveVector(b, [this](double* x) { solveInPlace(x); });
+}
+
+double DiagonalMatrix::Determinant() const noexcept {
+  double det = 1;
+  for (double value : data_) det *= value;
+  return det;
+}
+
+DiagonalMatrix DiagonalMatrix::InverseMatrix() const {
+  if (Determinant() == 0) throw NonInvertibleError();
+  DiagonalMatrix inverse(size_);
+  for (int i = 0; i < size_; i++) {
+    inverse.data_[i] = 1 / data_[i];
+    MatrixService::doubleLegit(inverse.data_[i]);
+  }
+  return inverse;
+}
+
+// TriangularMatrix
+
+TriangularMatrix::TriangularMatrix(const int size, const Triangle triangle)
+    : PackedMatrix(size, static_cast<size_t>(size) * (size + 1) / 2),
+      triangle_(triangle) {}
+
+TriangularMatrix::TriangularMatrix(const Matrix& matrix,
+                                   const Triangle triangle)
+    : TriangularMatrix(squareOrder(matrix), triangle) {
+  const std::vector<double> dense = readSquare(matrix);
+  for (int i = 0; i < size_; i++) {
+    for (int j = 0; j < size_; j++) {
+      const double value = dense[static_cast<size_t>(i) * size_ + j];
+      if (triangle_ == Triangle::Lower ? j <= i : j >= i)
+        data_[offset(i, j)] = value;
+      else if (value != 0)
+        throw InputError();
+    }
+  }
+}
+
+size_t TriangularMatrix::offset(const int row, const int col) const noexcept {
+  const size_t i = row;
+  if (triangle_ == Triangle::Lower) return i * (i + 1) / 2 + col;
+  return i * size_ - i * (i - 1) / 2 + (col - row);
+}
+
+double TriangularMatrix::getElement(const int row, const int col) const {
+  checkIndex(row, col);
+  if (triangle_ == Triangle::Lower ? col > row : col < row) return 0;
+  return data_[offset(row, col)];
+}
+
+void TriangularMatrix::setElement(const int row, const int col,
+                                  const double value) {
+  checkIndex(row, col);
+  if (triangle_ == Triangle::Lower ? col > row : col < row)
+    throw OutOfRangeError();
+  MatrixService::doubleLegit(value);
+  data_[offset(row, col)] = value;
+}
+
+TriangularMatrix::operator Matrix() const {
+  std::vector<double> dense(static_cast<size_t>(size_) * size_, 0);
+  for (int i = 0; i < size_; i++) {
+    const int from = triangle_ == Triangle::Lower ? 0 : i;
+    const int to = triangle_ == Triangle::Lower ? i + 1 : size_;
+    const double* row = data_.data() + offset(i, from);
+    std::copy(row, row + (to - from),
+              dense.begin() + static_cast<size_t>(i) * size_ + from);
+  }
+  return Matrix(size_, size_, size_ * size_, dense.data());
+}
+
+Matrix TriangularMatrix::operator*(const Matrix& other) const {
+  return multiplyRows(other, [this](int i, const double* b, int m,
+                                    double* c) {
+    const int from = triangle_ == Triangle::Lower ? 0 : i;
+    const int to = triangle_ == Triangle::Lower ? i + 1 : size_;
+    const double* t_row = data_.data() + offset(i, from) - from;
+    for (int p = from; p < to; p++) {
+      const double* b_row = b + static_cast<size_t>(p) * m;
+      for (int j = 0; j < m; j++) c[j] += t_row[p] * b_row[j];
+    }
+  });
+}
+
+Vector TriangularMatrix::operator*(const Vector& x) const {
+  const std::vector<double> dense = readOperand(x);
+  Vector y(size_);
+  for (int i = 0; i < size_; i++) {
+    const int from = triangle_ == Triangle::Lower ? 0 : i;
+    const int to = triangle_ == Triangle::Lower ? i + 1 : size_;
+    y[i] = MatrixService::dotProduct(data_.data() + offset(i, from),
+                                     dense.data() + from, to - from);
+  }
+  return y;
+}
+
+void TriangularMatrix::solveInPlace(double* x) const {
+  if (triangle_ == Triangle::Lower) {
+    for (int i = 0; i < size_; i++) {
+      const double* row = data_.data() + offset(i, 0);
+      x[i] = (x[i] - MatrixService::dotProduct(row, x, i)) / row[i];
+    }
+  } else {
+    for (int i = size_ - 1; i >= 0; i--) {
+      const double* row = data_.data() + offset(i, i);
+      x[i] = (x[i] - MatrixService::dotProduct(row + 1, x + i + 1,
+                                               size_ - i - 1)) /
+             row[0];
+    }
+  }
+}
+
+void TriangularMatrix::solveTransposedInPlace(double* x) const {
+  // T^T has the other triangle: columns of T are eliminated one by one.
+  if (triangle_ == Triangle::Lower) {
+    for (int i = size_ - 1; i >= 0; i--) {
+      const double* row = data_.data() + offset(i, 0);
+      x[i] /= row[i];
+      for (int j = 0; j < i; j++) x[j] -= row[j] * x[i];
+    }
+  } else {
+    for (int i = 0; i < size_; i++) {
+      const double* row = data_.data() + offset(i, i);
+      x[i] /= row[0];
+      for (int j = i + 1; j < size_; j++) x[j] -= row[j - i] * x[i];
+    }
+  }
+}
+
+Matrix TriangularMatrix::Solve(const Matrix& b) const {
+  if (Determinant() == 0) throw NonInvertibleError();
+  return solveColumns(b, [this](double* x) { solveInPlace(x); });
+}
+
+Vector TriangularMatrix::Solve(const Vector& b) const {
+  if (Determinant() == 0) throw NonInvertibleError();
+  return solveVector(b, [this](double* x) { solveInPlace(x); });
+}
+
+double TriangularMatrix::Determinant() const noexcept {
+  double det = 1;
+  for (int i = 0; i < size_; i++) det *= data_[offset(i, i)];
+  return det;
+}
+
+TriangularMatrix TriangularMatrix::InverseMatrix() const {
+  if (Determinant() == 0) throw NonInvertibleError();
+  TriangularMatrix inverse(size_, triangle_);
+  std::vector<double> column(size_);
+  for (int j = 0; j < size_; j++) {
+    std::fill(column.begin(), column.end(), 0);
+    column[j] = 1;
+    solveInPlace(column.data());
+    const int from = triangle_ == Triangle::Lower ? j : 0;
+    const int to = triangle_ == Triangle::Lower ? size_ : j + 1;
+    for (int i = from; i < to; i++) {
+      MatrixService::doubleLegit(column[i]);
+      inverse.data_[inverse.offset(i, j)] = column[i];
+    }
+  }
+  return inverse;
+}
+
+// SymmetricMatrix
+
+SymmetricMatrix::SymmetricMatrix(const Matrix& matrix)
+    : SymmetricMatrix(squareOrder(matrix)) {
+  const std::vector<double> dense = readSquare(matrix);
+  for (int i = 0; i < size_; i++) {
+    for (int j = 0; j <= i; j++) {
+      const double value = dense[static_cast<size_t>(i) * size_ + j];
+      if (!MatrixService::doubleEq(value,
+                                   dense[static_cast<size_t>(j) * size_ + i]))
+        throw InputError();
+      data_[offset(i, j)] = value;
+    }
+  }
+}
+
+size_t SymmetricMatrix::offset(const int row, const int col) const noexcept {
+  const size_t i = std::max(row, col);
+  return i * (i + 1) / 2 + std::min(row, col);
+}
+
+double SymmetricMatrix::getElement(const int row, const int col) const {
+  checkIndex(row, col);
+  return data_[offset(row, col)];
+}
+
+void SymmetricMatrix::setElement(const int row, const int col,
+                                 const double value) {
+  checkIndex(row, col);
+  MatrixService::doubleLegit(value);
+  data_[offset(row, col)] = value;
+}
+
+SymmetricMatrix::operator Matrix() const {
+  std::vector<double> dense(static_cast<size_t>(size_) * size_);
+  for (int i = 0; i < size_; i++) {
+    for (int j = 0; j <= i; j++) {
+      dense[static_cast<size_t>(i) * size_ + j] =
+          dense[static_cast<size_t>(j) * size_ + i] = data_[offset(i, j)];
+    }
+  }
+  return Matrix(size_, size_, size_ * size_, dense.data());
+}
+
+Matrix SymmetricMatrix::operator*(const Matrix& other) const {
+  return multiplyRows(other, [this](int i, const double* b, int m,
+                                    double* c) {
+    for (int p = 0; p < size_; p++) {
+      const double s_ip = data_[offset(i, p)];
+      const double* b_row = b + static_cast<size_t>(p) * m;
+      for (int j = 0; j < m; j++) c[j] += s_ip * b_row[j];
+    }
+  });
+}
+
+Vector SymmetricMatrix::operator*(const Vector& x) const {
+  const std::vector<double> dense = readOperand(x);
+  Vector y(size_);
+  // Every stored element contributes to two rows (one for the diagonal).
+  for (int i = 0; i < size_; i++) {
+    const double* row = data_.data() + offset(i, 0);
+    y[i] += MatrixService::dotProduct(row, dense.data(), i + 1);
+    for (int j = 0; j < i; j++) y[j] += row[j] * dense[i];
+  }
+  return y;
+}
+
+bool SymmetricMatrix::cholesky(TriangularMatrix& factor) const {
+  for (int i = 0; i < size_; i++) {
+    double* l_row = factor.data_.data() + factor.offset(i, 0);
+    const double* s_row = data_.data() + offset(i, 0);
+    for (int j = 0; j <= i; j++) {
+      const double* l_col = factor.data_.data() + factor.offset(j, 0);
+      const double sum = s_row[j] - MatrixService::dotProduct(l_row, l_col, j);
+      if (j < i) {
+        l_row[j] = sum / l_col[j];
+      } else {
+        if (!(sum > 0)) return false;
+        l_row[i] = std::sqrt(sum);
+      }
+    }
+  }
+  return true;
+}
+
+Matrix SymmetricMatrix::Solve(const Matrix& b) const {
+  TriangularMatrix factor(size_, Triangle::Lower);
+  if (!cholesky(factor)) return Matrix(*this).Solve(b);
+  return solveColumns(b, [&factor](double* x) {
+    factor.solveInPlace(x);
+    factor.solveTransposedInPlace(x);
+  });
+}
+
+Vector SymmetricMatrix::Solve(const Vector& b) const {
+  TriangularMatrix factor(size_, Triangle::Lower);
+  if (!cholesky(factor)) return Matrix(*this).Solve(b);
+  return solveVector(b, [&factor](double* x) {
+    factor.solveInPlace(x);
+    factor.solveTransposedInPlace(x);
+  });
+}
+
+double SymmetricMatrix::Determinant() const {
+  TriangularMatrix factor(size_, Triangle::Lower);
+  if (cholesky(factor)) {
+    const double det = factor.Determinant();
+    return det * det;
+  }
+  const Matrix full(*this);
+  return LUDecomposition<double>(full.getMatrix(), size_).determinant();
+}
+
+SymmetricMatrix SymmetricMatrix::InverseMatrix() const {
+  SymmetricMatrix inverse(size_);
+  TriangularMatrix factor(size_, Triangle::Lower);
+  if (cholesky(factor)) {
+    // S^-1 = L^-T * L^-1, only the lower triangle is computed.
+    std::vector<double> column(size_);
+    for (int j = 0; j < size_; j++) {
+      std::fill(column.begin(), column.end(), 0);
+      column[j] = 1;
+      factor.solveInPlace(column.data());
+      factor.solveTransposedInPlace(column.data());
+      for (int i = j; i < size_; i++) {
+        MatrixService::doubleLegit(column[i]);
+        inverse.data_[offset(i, j)] = column[i];
+      }
+    }
+  } else {
+    const Matrix full = Matrix(*this).InverseMatrix(Precision::Double);
+    for (int i = 0; i < size_; i++) {
+      for (int j = 0; j <= i; j++)
+        inverse.data_[offset(i, j)] = full.getElement(i, j);
+    }
+  }
+  return inverse;
+}
+
+// BandedMatrix
+
+struct BandedMatrix::Factors {
+  int n;                     ///< Order of the matrix.
+  int lower;                 ///< Number of subdiagonals of L.
+  int width;                 ///< Number of superdiagonals of U.
+  std::vector<double> band;  ///< The factors column by column.
+  std::vector<int> pivots;   ///< Row swapped with each row.
+  int sign = 1;              ///< Sign of the permutation.
+  bool singular = false;     ///< Whether a zero pivot was met.
+
+  /**
+   * @brief Retrieves an element of the factors (j - width <= i <= j + lower).
+   */
+  double& at(const int i, const int j) {
+    return band[static_cast<size_t>(j) * (width + lower + 1) + width + i - j];
+  }
+  double at(const int i, const int j) const {
+    return band[static_cast<size_t>(j) * (width + lower + 1) + width + i - j];
+  }
+  /**
+   * @brief Solves A * x = b in place.
+   */
+  void solve(double* x) const {
+    for (int j = 0; j < n; j++) {
+      std::swap(x[j], x[pivots[j]]);
+      const int last = std::min(n - 1, j + lower);
+      for (int i = j + 1; i <= last; i++) x[i] -= at(i, j) * x[j];
+    }
+    for (int j = n - 1; j >= 0; j--) {
+      x[j] /= at(j, j);
+      for (int i = std::max(0, j - width); i < j; i++) x[i] -= at(i, j) * x[j];
+    }
+  }
+};
+
+BandedMatrix::BandedMatrix(const int size, const int lower, const int upper)
+    : PackedMatrix(size, bandStorage(size, lower, upper)),
+      lower_(lower),
+      upper_(upper) {}
+
+size_t BandedMatrix::bandStorage(const int size, const int lower,
+                                 const int upper) {
+  if (size <= 0) throw DimentionError();
+  if (lower < 0 || upper < 0 || lower >= size || upper >= size)
+    throw InputError();
+  return static_cast<size_t>(size) * (lower + upper + 1);
+}
+
+BandedMatrix::BandedMatrix(const Matrix& matrix, const int lower,
+                           const int upper)
+    : BandedMatrix(squareOrder(matrix), lower, upper) {
+  const std::vector<double> dense = readSquare(matrix);
+  for (int i = 0; i < size_; i++) {
+    for (int j = 0; j < size_; j++) {
+      const double value = dense[static_cast<size_t>(i) * size_ + j];
+      if (j - i <= upper_ && i - j <= lower_)
+        data_[static_cast<size_t>(i) * (lower_ + upper_ + 1) + j - i +
+              lower_] = value;
+      else if (value != 0)
+        throw InputError();
+    }
+  }
+}
+
+double BandedMatrix::getElement(const int row, const int col) const {
+  checkIndex(row, col);
+  if (col - row > upper_ || row - col > lower_) return 0;
+  return data_[static_cast<size_t>(row) * (lower_ + upper_ + 1) + col - row +
+               lower_];
+}
+
+void BandedMatrix::setElement(const int row, const int col,
+                              const double value) {
+  checkIndex(row, col);
+  if (col - row > upper_ || row - col > lower_) throw OutOfRangeError();
+  MatrixService::doubleLegit(value);
+  data_[static_cast<size_t>(row) * (lower_ + upper_ + 1) + col - row +
+        lower_] = value;
+}
+
+BandedMatrix::operator Matrix() const {
+  std::vector<double> dense(static_cast<size_t>(size_) * size_, 0);
+  for (int i = 0; i < size_; i++) {
+    const int from = std::max(0, i - lower_);
+    const int to = std::min(size_ - 1, i + upper_);
+    for (int j = from; j <= to; j++)
+      dense[static_cast<size_t>(i) * size_ + j] =
+          data_[static_cast<size_t>(i) * (lower_ + upper_ + 1) + j - i +
+                lower_];
+  }
+  return Matrix(size_, size_, size_ * size_, dense.data());
+}
+
+Matrix BandedMatrix::operator*(const Matrix& other) const {
+  return multiplyRows(other, [this](int i, const double* b, int m,
+                                    double* c) {
+    const double* row =
+        data_.data() + static_cast<size_t>(i) * (lower_ + upper_ + 1) + lower_ -
+        i;
+    const int to = std::min(size_ - 1, i + upper_);
+    for (int p = std::max(0, i - lower_); p <= to; p++) {
+      const double* b_row = b + static_cast<size_t>(p) * m;
+      for (int j = 0; j < m; j++) c[j] += row[p] * b_row[j];
+    }
+  });
+}
+
+Vector BandedMatrix::operator*(const Vector& x) const {
+  const std::vector<double> dense = readOperand(x);
+  Vector y(size_);
+  for (int i = 0; i < size_; i++) {
+    const int from = std::max(0, i - lower_);
+    const int to = std::min(size_ - 1, i + upper_);
+    y[i] = MatrixService::dotProduct(
+        data_.data() + static_cast<size_t>(i) * (lower_ + upper_ + 1) +
+            from - i + lower_,
+        dense.data() + from, to - from + 1);
+  }
+  return y;
+}
+
+BandedMatrix::Factors BandedMatrix::factorize() const {
+  Factors f;
+  f.n = size_;
+  f.lower = lower_;
+  f.width = lower_ + upper_;
+  f.band.assign(static_cast<size_t>(size_) * (f.width + lower_ + 1), 0);
+  f.pivots.resize(size_);
+  for (int i = 0; i < size_; i++) {
+    const int to = std::min(size_ - 1, i + upper_);
+    for (int j = std::max(0, i - lower_); j <= to; j++)
+      f.at(i, j) = getElement(i, j);
+  }
+  // Row swaps move elements of U up to lower_ diagonals beyond upper_.
+  int last_col = 0;
+  for (int k = 0; k < size_; k++) {
+    const int last_row = std::min(size_ - 1, k + lower_);
+    int pivot = k;
+    for (int i = k + 1; i <= last_row; i++) {
+      if (std::fabs(f.at(i, k)) > std::fabs(f.at(pivot, k))) pivot = i;
+    }
+    f.pivots[k] = pivot;
+    if (f.at(pivot, k) == 0) {
+      f.singular = true;
+      break;
+    }
+    last_col = std::max(last_col, std::min(size_ - 1, pivot + upper_));
+    if (pivot != k) {
+      for (int j = k; j <= last_col; j++) std::swap(f.at(k, j), f.at(pivot, j));
+      f.sign = -f.sign;
+    }
+    for (int i = k + 1; i <= last_row; i++) {
+      const double factor = f.at(i, k) /= f.at(k, k);
+      for (int j = k + 1; j <= last_col; j++) f.at(i, j) -= factor * f.at(k, j);
+    }
+  }
+  return f;
+}
+
+Matrix BandedMatrix::Solve(const Matrix& b) const {
+  const Factors f = factorize();
+  if (f.singular) throw NonInvertibleError();
+  return solveColumns(b, [&f](double* x) { f.solve(x); });
+}
+
+Vector BandedMatrix::Solve(const Vector& b) const {
+  const Factors f = factorize();
+  if (f.singular) throw NonInvertibleError();
+  return solveVector(b, [&f](double* x) { f.solve(x); });
+}
+
+double BandedMatrix::Determinant() const {
+  const Factors f = factorize();
+  if (f.singular) return 0;
+  double det = f.sign;
+  for (int i = 0; i < size_; i++) det *= f.at(i, i);
+  return det;
+}
+
+Matrix BandedMatrix::InverseMatrix() const {
+  const Factors f = factorize();
+  if (f.singular) throw NonInvertibleError();
+  std::vector<double> dense(static_cast<size_t>(size_) * size_, 0);
+  for (int i = 0; i < size_; i++) dense[static_cast<size_t>(i) * size_ + i] = 1;
+  const Matrix identity(size_, size_, size_ * size_, dense.data());
+  return solveColumns(identity, [&f](double* x) { f.solve(x); });
+}
@@ -0,0 +1,502 @@
+#ifndef MATRIX_STRUCTURED
+#define MATRIX_STRUCTURED
+#include <vector>
+
+#include "matrix_cpp.hpp"
+#include "matrix_exceptions.hpp"
+#include "matrix_vector.hpp"
+
+/**
+ * @brief Selects the triangle of a triangular matrix.
+ */
+enum class Triangle { Lower, Upper };
+
+/**
+ * @brief Common part of the square matrices storing only the elements their
+ * structure allows to be non-zero.
+ * @note Methods without "noexcept" keyword include verios of throws.
+ * @see matrix_exceptions.hpp
+ */
+class PackedMatrix {
+ public:
+  /**
+   * @brief Retrieves the order of the matrix.
+   * @return Number of rows (and columns).
+   */
+  int getSize() const noexcept { return size_; }
+  /**
+   * @brief Retrieves the number of stored elements.
+   * @return Size of the packed storage.
+   */
+  long getPackedSize() const noexcept {
+    return static_cast<long>(data_.size());
+  }
+  /**
+   * @brief Retrieves the packed storage.
+   * @return Constant pointer to the first stored element.
+   */
+  const double* getData() const noexcept { return data_.data(); }
+
+ protected:
+  int size_{0};               ///< Order of the matrix.
+  std::vector<double> data_;  ///< The stored elements.
+
+  /**
+   * @brief Allocates a zero matrix.
+   * @param size The order of the matrix.
+   * @param packed The number of stored elements.
+   */
+  PackedMatrix(const int size, const size_t packed);
+  /**
+   * @brief Checks the indices of an element.
+   * @param row Row index.
+   * @param col Column index.
+   * @throws OutOfRangeError if the element is outside of the matrix.
+   */
+  void checkIndex(const int row, const int col) const;
+  /**
+   * @brief Checks that a matrix is set and square.
+   * @param matrix The matrix to check.
+   * @return The order of the matrix.
+   */
+  static int squareOrder(const Matrix& matrix);
+  /**
+   * @brief Copies a square matrix into a row-major array.
+   * @param matrix The matrix to read.
+   * @return The elements row by row.
+   */
+  static std::vector<double> readSquare(const Matrix& matrix);
+  /**
+   * @brief Copies a matrix with size_ rows into a row-major array.
+   * @param matrix The matrix to read.
+   * @return The elements row by row.
+   */
+  std::vector<double> readOperand(const Matrix& matrix) const;
+  /**
+   * @brief Copies a vector of size_ elements.
+   * @param vector The vector to read.
+   * @return The elements.
+   */
+  std::vector<double> readOperand(const Vector& vector) const;
+  /**
+   * @brief Multiplies the matrix by the columns of a row-major array.
+   * @param row_product Callable row_product(i, b, cols, c_row) adding row i
+   * of the product to c_row.
+   * @param b The right operand with size_ rows.
+   * @return The product.
+   */
+  template <typename RowProduct>
+  Matrix multiplyRows(const Matrix& b, RowProduct&& row_product) const;
+  /**
+   * @brief Solves the system for every column of the right hand side.
+   * @param b The right hand sides.
+   * @param solve Callable solving in place for one column.
+   * @return The solution.
+   */
+  template <typename Solve>
+  Matrix solveColumns(const Matrix& b, Solve&& solve) const;
+  /**
+   * @brief Solves the system for a vector right hand side.
+   * @param b The right hand side.
+   * @param solve Callable solving in place.
+   * @return The solution.
+   */
+  template <typename Solve>
+  Vector solveVector(const Vector& b, Solve&& solve) const;
+};
+
+/**
+ * @brief A diagonal matrix (n stored elements).
+ */
+class DiagonalMatrix : public PackedMatrix {
+ public:
+  /**
+   * @brief Creates a zero diagonal matrix.
+   * @param size The order of the matrix.
+   */
+  explicit DiagonalMatrix(const int size) : PackedMatrix(size, size) {}
+  /**
+   * @brief Creates a diagonal matrix from its diagonal.
+   * @param size The order of the matrix.
+   * @param n Number of elements in the array.
+   * @param diagonal The diagonal elements.
+   */
+  DiagonalMatrix(const int size, const int n, const double diagonal[]);
+  /**
+   * @brief Packs a diagonal matrix.
+   * @param matrix A square matrix with zero off-diagonal elements.
+   * @throws InputError if the matrix is not diagonal.
+   */
+  explicit DiagonalMatrix(const Matrix& matrix);
+
+  /**
+   * @brief Retrieves an element.
+   * @param row Row index.
+   * @param col Column index.
+   * @return The element (zero outside of the diagonal).
+   */
+  double getElement(const int row, const int col) const;
+  /**
+   * @brief Sets an element of the diagonal.
+   * @param row Row index.
+   * @param col Column index (must be equal to row).
+   * @param value The new value.
+   */
+  void setElement(const int row, const int col, const double value);
+  /**
+   * @brief Unpacks the matrix.
+   * @return The full matrix.
+   */
+  operator Matrix() const;
+  /**
+   * @brief Multiplies the matrix by a matrix in O(n * m).
+   * @param other The matrix to multiply by.
+   * @return Resulting matrix.
+   */
+  Matrix operator*(const Matrix& other) const;
+  /**
+   * @brief Multiplies the matrix by a vector in O(n).
+   * @param x The vector to multiply by.
+   * @return Resulting vector.
+   */
+  Vector operator*(const Vector& x) const;
+  /**
+   * @brief Solves the system D * X = B.
+   * @param b The right hand sides.
+   * @return The solution.
+   */
+  Matrix Solve(const Matrix& b) const;
+  /**
+   * @brief Solves the system D * x = b.
+   * @param b The right hand side.
+   * @return The solution.
+   */
+  Vector Solve(const Vector& b) const;
+  /**
+   * @brief Calculates the determinant in O(n).
+   * @return The determinant.
+   */
+  double Determinant() const noexcept;
+  /**
+   * @brief Calculates the inverse matrix in O(n).
+   * @return The inverse matrix.
+   */
+  DiagonalMatrix InverseMatrix() const;
+
+ private:
+  /**
+   * @brief Solves in place.
+   * @param x The right hand side on entry, the solution on exit.
+   */
+  void solveInPlace(double* x) const;
+};
+
+/**
+ * @brief A lower or upper triangular matrix packed row by row
+ * (n * (n + 1) / 2 stored elements).
+ */
+class TriangularMatrix : public PackedMatrix {
+ public:
+  /**
+   * @brief Creates a zero triangular matrix.
+   * @param size The order of the matrix.
+   * @param triangle The triangle that is stored.
+   */
+  TriangularMatrix(const int size, const Triangle triangle);
+  /**
+   * @brief Packs a triangular matrix.
+   * @param matrix A square matrix with zeros outside of the triangle.
+   * @param triangle The triangle that is stored.
+   * @throws InputError if the matrix is not triangular.
+   */
+  TriangularMatrix(const Matrix& matrix, const Triangle triangle);
+
+  /**
+   * @brief Retrieves the stored triangle.
+   * @return The triangle.
+   */
+  Triangle getTriangle() const noexcept { return triangle_; }
+  /**
+   * @brief Retrieves an element.
+   * @param row Row index.
+   * @param col Column index.
+   * @return The element (zero outside of the triangle).
+   */
+  double getElement(const int row, const int col) const;
+  /**
+   * @brief Sets an element of the triangle.
+   * @param row Row index.
+   * @param col Column index.
+   * @param value The new value.
+   */
+  void setElement(const int row, const int col, const double value);
+  /**
+   * @brief Unpacks the matrix.
+   * @return The full matrix.
+   */
+  operator Matrix() const;
+  /**
+   * @brief Multiplies the matrix by a matrix (half the work of a product of
+   * full matrices).
+   * @param other The matrix to multiply by.
+   * @return Resulting matrix.
+   */
+  Matrix operator*(const Matrix& other) const;
+  /**
+   * @brief Multiplies the matrix by a vector.
+   * @param x The vector to multiply by.
+   * @return Resulting vector.
+   */
+  Vector operator*(const Vector& x) const;
+  /**
+   * @brief Solves the system T * X = B by substitution in O(n^2) per column.
+   * @param b The right hand sides.
+   * @return The solution.
+   */
+  Matrix Solve(const Matrix& b) const;
+  /**
+   * @brief Solves the system T * x = b by substitution in O(n^2).
+   * @param b The right hand side.
+   * @return The solution.
+   */
+  Vector Solve(const Vector& b) const;
+  /**
+   * @brief Calculates the determinant in O(n).
+   * @return The determinant.
+   */
+  double Determinant() const noexcept;
+  /**
+   * @brief Calculates the inverse matrix (triangular as well).
+   * @return The inverse matrix.
+   */
+  TriangularMatrix InverseMatrix() const;
+
+ private:
+  Triangle triangle_;  ///< The stored triangle.
+
+  /**
+   * @brief Retrieves the offset of a stored element.
+   * @param row Row index.
+   * @param col Column index (inside of the triangle).
+   * @return Index in the packed storage.
+   */
+  size_t offset(const int row, const int col) const noexcept;
+  /**
+   * @brief Solves in place.
+   * @param x The right hand side on entry, the solution on exit.
+   */
+  void solveInPlace(double* x) const;
+  /**
+   * @brief Solves the transposed system in place.
+   * @param x The right hand side on entry, the solution on exit.
+   */
+  void solveTransposedInPlace(double* x) const;
+
+  friend class SymmetricMatrix;
+};
+
+/**
+ * @brief A symmetric matrix storing its lower triangle row by row
+ * (n * (n + 1) / 2 stored elements).
+ */
+class SymmetricMatrix : public PackedMatrix {
+ public:
+  /**
+   * @brief Creates a zero symmetric matrix.
+   * @param size The order of the matrix.
+   */
+  explicit SymmetricMatrix(const int size)
+      : PackedMatrix(size, static_cast<size_t>(size) * (size + 1) / 2) {}
+  /**
+   * @brief Packs a symmetric matrix.
+   * @param matrix A square symmetric matrix.
+   * @throws InputError if the matrix is not symmetric.
+   */
+  explicit SymmetricMatrix(const Matrix& matrix);
+
+  /**
+   * @brief Retrieves an element.
+   * @param row Row index.
+   * @param col Column index.
+   * @return The element.
+   */
+  double getElement(const int row, const int col) const;
+  /**
+   * @brief Sets an element together with its mirror.
+   * @param row Row index.
+   * @param col Column index.
+   * @param value The new value.
+   */
+  void setElement(const int row, const int col, const double value);
+  /**
+   * @brief Unpacks the matrix.
+   * @return The full matrix.
+   */
+  operator Matrix() const;
+  /**
+   * @brief Multiplies the matrix by a matrix.
+   * @param other The matrix to multiply by.
+   * @return Resulting matrix.
+   */
+  Matrix operator*(const Matrix& other) const;
+  /**
+   * @brief Multiplies the matrix by a vector.
+   * @param x The vector to multiply by.
+   * @return Resulting vector.
+   */
+  Vector operator*(const Vector& x) const;
+  /**
+   * @brief Solves the system S * X = B with a Cholesky decomposition, or
+   * with a full LU decomposition when S is not positive definite.
+   * @param b The right hand sides.
+   * @return The solution.
+   */
+  Matrix Solve(const Matrix& b) const;
+  /**
+   * @brief Solves the system S * x = b.
+   * @param b The right hand side.
+   * @return The solution.
+   * @see Solve(const Matrix&)
+   */
+  Vector Solve(const Vector& b) const;
+  /**
+   * @brief Calculates the determinant in O(n^3).
+   * @return The determinant.
+   */
+  double Determinant() const;
+  /**
+   * @brief Calculates the inverse matrix (symmetric as well).
+   * @return The inverse matrix.
+   */
+  SymmetricMatrix InverseMatrix() const;
+
+ private:
+  /**
+   * @brief Retrieves the offset of a stored element.
+   * @param row Row index.
+   * @param col Column index.
+   * @return Index in the packed storage.
+   */
+  size_t offset(const int row, const int col) const noexcept;
+  /**
+   * @brief Calculates the Cholesky factor L (S = L * L^T).
+   * @param factor Output parameter for the lower triangular factor.
+   * @return False if the matrix is not positive definite.
+   */
+  bool cholesky(TriangularMatrix& factor) const;
+};
+
+/**
+ * @brief A banded matrix storing the diagonals from -lower to +upper row by
+ * row (n * (lower + upper + 1) stored elements).
+ */
+class BandedMatrix : public PackedMatrix {
+ public:
+  /**
+   * @brief Creates a zero banded matrix.
+   * @param size The order of the matrix.
+   * @param lower The number of subdiagonals.
+   * @param upper The number of superdiagonals.
+   * @throws InputError if a bandwidth is negative or not below the order.
+   */
+  BandedMatrix(const int size, const int lower, const int upper);
+  /**
+   * @brief Packs a banded matrix.
+   * @param matrix A square matrix with zeros outside of the band.
+   * @param lower The number of subdiagonals.
+   * @param upper The number of superdiagonals.
+   * @throws InputError if the matrix has elements outside of the band.
+   */
+  BandedMatrix(const Matrix& matrix, const int lower, const int upper);
+
+  /**
+   * @brief Retrieves the number of subdiagonals.
+   * @return Lower bandwidth.
+   */
+  int getLower() const noexcept { return lower_; }
+  /**
+   * @brief Retrieves the number of superdiagonals.
+   * @return Upper bandwidth.
+   */
+  int getUpper() const noexcept { return upper_; }
+  /**
+   * @brief Retrieves an element.
+   * @param row Row index.
+   * @param col Column index.
+   * @return The element (zero outside of the band).
+   */
+  double getElement(const int row, const int col) const;
+  /**
+   * @brief Sets an element of the band.
+   * @param row Row index.
+   * @param col Column index.
+   * @param value The new value.
+   */
+  void setElement(const int row, const int col, const double value);
+  /**
+   * @brief Unpacks the matrix.
+   * @return The full matrix.
+   */
+  operator Matrix() const;
+  /**
+   * @brief Multiplies the matrix by a matrix in O(n * m * b).
+   * @param other The matrix to multiply by.
+   * @return Resulting matrix.
+   */
+  Matrix operator*(const Matrix& other) const;
+  /**
+   * @brief Multiplies the matrix by a vector in O(n * b).
+   * @param x The vector to multiply by.
+   * @return Resulting vector.
+   */
+  Vector operator*(const Vector& x) const;
+  /**
+   * @brief Solves the system A * X = B with a banded LU decomposition with
+   * partial pivoting in O(n * b^2).
+   * @param b The right hand sides.
+   * @return The solution.
+   */
+  Matrix Solve(const Matrix& b) const;
+  /**
+   * @brief Solves the system A * x = b.
+   * @param b The right hand side.
+   * @return The solution.
+   * @see Solve(const Matrix&)
+   */
+  Vector Solve(const Vector& b) const;
+  /**
+   * @brief Calculates the determinant in O(n * b^2).
+   * @return The determinant.
+   */
+  double Determinant() const;
+  /**
+   * @brief Calculates the inverse matrix (which is full in general).
+   * @return The inverse matrix.
+   */
+  Matrix InverseMatrix() const;
+
+ private:
+  int lower_;  ///< Number of subdiagonals.
+  int upper_;  ///< Number of superdiagonals.
+
+  /**
+   * @brief Checks the order and bandwidths before anything is allocated.
+   * @param size The order of the matrix.
+   * @param lower The number of subdiagonals.
+   * @param upper The number of superdiagonals.
+   * @return The number of stored elements.
+   * @throws DimentionError if the order is not positive.
+   * @throws InputError if a bandwidth is negative or not below the order.
+   */
+  static size_t bandStorage(const int size, const int lower, const int upper);
+  /**
+   * @brief Banded LU factors: U gets lower_ extra superdiagonals of fill-in.
+   */
+  struct Factors;
+  /**
+   * @brief Factorizes the matrix.
+   * @return The factors.
+   */
+  Factors factorize() const;
+};
+#endif  // MATRIX_STRUCTURED
@@ -0,0 +1,629 @@
+#include "matrix_tiled.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "matrix_parallel.hpp"
+#include "matrix_scheduler.hpp"
+
+// First bytes of every tiled matrix file.
+static const char TILE_MAGIC[8] = {'M', 'T', 'I', 'L', 'E', 'D', '0', '1'};
+// Size of the file header: the magic, rows, columns and tile size.
+static constexpr off_t TILE_HEADER = sizeof(TILE_MAGIC) + 3 * sizeof(int64_t);
+
+struct TiledMatrix::Tile {
+  std::vector<double> data;  ///< The elements row by row, padded with zeros.
+  bool ready = false;        ///< Whether the elements were loaded.
+  bool failed = false;       ///< Whether loading the elements failed.
+  bool dirty = false;        ///< Whether the elements differ from the file.
+};
+
+struct TiledMatrix::State {
+  /**
+   * @brief A cached tile and its position in the eviction order.
+   */
+  struct Entry {
+    std::shared_ptr<Tile> tile;
+    std::list<long>::iterator position;
+  };
+
+  std::string path;                       ///< The file of the matrix.
+  int fd = -1;                            ///< The open file.
+  int rows = 0;                           ///< Number of rows.
+  int cols = 0;                           ///< Number of columns.
+  int tile_size = 0;                      ///< Order of the tiles.
+  int cache_tiles = 0;                    ///< Limit of cached tiles.
+  int tile_rows = 0;                      ///< Number of tile rows.
+  int tile_cols = 0;                      ///< Number of tile columns.
+  std::mutex mutex;                       ///< Guards the cache.
+  std::list<long> order;                  ///< Tiles, most recently used first.
+  std::unordered_map<long, Entry> cache;  ///< Tiles in memory by index.
+  int in_flight = 0;                      ///< Number of running prefetches.
+  std::atomic<long> reads{0};             ///< Tiles read so far.
+  std::atomic<long> writes{0};            ///< Tiles written so far.
+
+  ~State() noexcept {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (in_flight > 0) {
+      lock.unlock();
+      if (!MatrixScheduler::instance().runPending()) std::this_thread::yield();
+      lock.lock();
+    }
+    try {
+      writeBack();
+    } catch (...) {
+    }
+    if (fd >= 0) close(fd);
+  }
+  /**
+   * @brief Sets the dimensions.
+   */
+  void setShape(const int r, const int c, const int t) {
+    if (r <= 0 || c <= 0) throw DimentionError();
+    if (t <= 0 || cache_tiles <= 0) throw InputError();
+    rows = r;
+    cols = c;
+    tile_size = t;
+    tile_rows = (r + t - 1) / t;
+    tile_cols = (c + t - 1) / t;
+  }
+  /**
+   * @brief Retrieves the number of elements of a tile.
+   */
+  size_t tileElements() const noexcept {
+    return static_cast<size_t>(tile_size) * tile_size;
+  }
+  /**
+   * @brief Retrieves the position of a tile in the file.
+   */
+  off_t offset(const long id) const noexcept {
+    return TILE_HEADER +
+           static_cast<off_t>(id) * tileElements() * sizeof(double);
+  }
+  /**
+   * @brief Reads a tile from the file.
+   */
+  void read(const long id, double* data) {
+    char* bytes = reinterpret_cast<char*>(data);
+    size_t done = 0, total = tileElements() * sizeof(double);
+    while (done < total) {
+      const ssize_t count = pread(fd, bytes + done, total - done,
+                                  offset(id) + static_cast<off_t>(done));
+      if (count <= 0) throw InputError("Tiled matrix file read error.");
+      done += count;
+    }
+    reads++;
+  }
+  /**
+   * @brief Writes a tile to the file.
+   */
+  void write(const long id, const double* data) {
+    const char* bytes = reinterpret_cast<const char*>(data);
+    size_t done = 0, total = tileElements() * sizeof(double);
+    while (done < total) {
+      const ssize_t count = pwrite(fd, bytes + done, total - done,
+                                   offset(id) + static_cast<off_t>(done));
+      if (count <= 0) throw InputError("Tiled matrix file write error.");
+      done += count;
+    }
+    writes++;
+  }
+  /**
+   * @brief Writes the modified cached tiles (the lock must be held).
+   */
+  void writeBack() {
+    for (auto& [id, entry] : cache) {
+      if (entry.tile->ready && entry.tile->dirty) {
+        write(id, entry.tile->data.data());
+        entry.tile->dirty = false;
+      }
+    }
+  }
+  /**
+   * @brief Adds a tile to the cache and evicts the least recently used
+   * unreferenced tiles above the limit (the lock must be held).
+   */
+  void insert(const long id, const std::shared_ptr<Tile>& tile) {
+    order.push_front(id);
+    cache[id] = Entry{tile, order.begin()};
+    auto position = order.end();
+    while (static_cast<int>(cache.size()) > cache_tiles &&
+           position != order.begin()) {
+      --position;
+      Entry& entry = cache[*position];
+      if (entry.tile.use_count() > 1 || !entry.tile->ready) continue;
+      if (entry.tile->dirty) write(*position, entry.tile->data.data());
+      cache.erase(*position);
+      position = order.erase(position);
+    }
+  }
+  /**
+   * @brief Removes a tile from the cache (the lock must be held).
+   */
+  void erase(const long id, const Tile* tile) noexcept {
+    auto found = cache.find(id);
+    if (found == cache.end() || found->second.tile.get() != tile) return;
+    order.erase(found->second.position);
+    cache.erase(found);
+  }
+  /**
+   * @brief Waits until a prefetched tile is loaded, running queued tasks
+   * meanwhile.
+   */
+  void waitReady(std::unique_lock<std::mutex>& lock, const Tile& tile) {
+    while (!tile.ready) {
+      lock.unlock();
+      if (!MatrixScheduler::instance().runPending()) std::this_thread::yield();
+      lock.lock();
+    }
+    if (tile.failed) throw InputError("Tiled matrix file read error.");
+  }
+};
+
+TiledMatrix::TiledMatrix(const std::string& path, const int rows,
+                         const int cols, const int tile_size,
+                         const int cache_tiles)
+    : state_(std::make_unique<State>()) {
+  State& s = *state_;
+  s.path = path;
+  s.cache_tiles = cache_tiles;
+  s.setShape(rows, cols, tile_size);
+  s.fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (s.fd < 0) throw InputError("Tiled matrix file can not be created.");
+  char header[TILE_HEADER];
+  const int64_t shape[3]{rows, cols, tile_size};
+  std::memcpy(header, TILE_MAGIC, sizeof(TILE_MAGIC));
+  std::memcpy(header + sizeof(TILE_MAGIC), shape, sizeof(shape));
+  if (pwrite(s.fd, header, TILE_HEADER, 0) != TILE_HEADER ||
+      ftruncate(s.fd, s.offset(static_cast<long>(s.tile_rows) * s.tile_cols)))
+    throw InputError("Tiled matrix file can not be created.");
+}
+
+TiledMatrix::TiledMatrix(const std::string& path, const int cache_tiles)
+    : state_(std::make_unique<State>()) {
+  State& s = *state_;
+  s.path = path;
+  s.cache_tiles = cache_tiles;
+  s.fd = open(path.c_str(), O_RDWR);
+  if (s.fd < 0) throw InputError("Tiled matrix file can not be opened.");
+  char header[TILE_HEADER];
+  int64_t shape[3];
+  if (pread(s.fd, header, TILE_HEADER, 0) != TILE_HEADER ||
+      std::memcmp(header, TILE_MAGIC, sizeof(TILE_MAGIC)))
+    throw InputError("Not a tiled matrix file.");
+  std::memcpy(shape, header + sizeof(TILE_MAGIC), sizeof(shape));
+  for (int64_t value : shape) {
+    if (value <= 0 || value > INT32_MAX)
+      throw InputError("Not a tiled matrix file.");
+  }
+  s.setShape(static_cast<int>(shape[0]), static_cast<int>(shape[1]),
+             static_cast<int>(shape[2]));
+}
+
+TiledMatrix::TiledMatrix(const std::string& path, const Matrix& matrix,
+                         const int tile_size, const int cache_tiles)
+    : TiledMatrix(
+          path, matrix.getMatrix() ? matrix.getRows() : throw MatrixSetError(),
+          matrix.getCols(), tile_size, cache_tiles) {
+  const double** rows = matrix.getMatrix();
+  const int t = tile_size;
+  for (int i = 0; i < tileRowCount(); i++) {
+    for (int j = 0; j < tileColCount(); j++) {
+      std::shared_ptr<Tile> target = freshTile(i, j);
+      for (int r = 0; r < tileRows(i); r++) {
+        const double* source = rows[i * t + r] + j * t;
+        std::copy(source, source + tileCols(j),
+                  target->data.begin() + static_cast<size_t>(r) * t);
+      }
+    }
+  }
+}
+
+TiledMatrix::TiledMatrix(TiledMatrix&& other) noexcept
+    : state_(std::move(other.state_)) {}
+
+TiledMatrix::~TiledMatrix() noexcept = default;
+
+int TiledMatrix::getRows() const noexcept { return state_->rows; }
+
+int TiledMatrix::getCols() const noexcept { return state_->cols; }
+
+int TiledMatrix::getTileSize() const noexcept { return state_->tile_size; }
+
+const std::string& TiledMatrix::getPath() const noexcept {
+  return state_->path;
+}
+
+long TiledMatrix::getTileReads() const noexcept { return state_->reads; }
+
+long TiledMatrix::getTileWrites() const noexcept { return state_->writes; }
+
+int TiledMatrix::getCachedTiles() const noexcept {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return static_cast<int>(state_->cache.size());
+}
+
+int TiledMatrix::tileRows(const int tile_row) const noexcept {
+  return std::min(state_->tile_size,
+                  state_->rows - tile_row * state_->tile_size);
+}
+
+int TiledMatrix::tileCols(const int tile_col) const noexcept {
+  return std::min(state_->tile_size,
+                  state_->cols - tile_col * state_->tile_size);
+}
+
+int TiledMatrix::tileRowCount() const noexcept { return state_->tile_rows; }
+
+int TiledMatrix::tileColCount() const noexcept { return state_->tile_cols; }
+
+std::shared_ptr<TiledMatrix::Tile> TiledMatrix::tile(
+    const int tile_row, const int tile_col) const {
+  State& s = *state_;
+  const long id = static_cast<long>(tile_row) * s.tile_cols + tile_col;
+  std::unique_lock<std::mutex> lock(s.mutex);
+  auto found = s.cache.find(id);
+  if (found != s.cache.end()) {
+    s.order.splice(s.order.begin(), s.order, found->second.position);
+    std::shared_ptr<Tile> cached = found->second.tile;
+    s.waitReady(lock, *cached);
+    return cached;
+  }
+  auto loaded = std::make_shared<Tile>();
+  loaded->data.resize(s.tileElements());
+  s.insert(id, loaded);
+  lock.unlock();
+  try {
+    s.read(id, loaded->data.data());
+  } catch (...) {
+    lock.lock();
+    s.erase(id, loaded.get());
+    throw;
+  }
+  lock.lock();
+  loaded->ready = true;
+  return loaded;
+}
+
+std::shared_ptr<TiledMatrix::Tile> TiledMatrix::freshTile(const int tile_row,
+                                                          const int tile_col) {
+  State& s = *state_;
+  const long id = static_cast<long>(tile_row) * s.tile_cols + tile_col;
+  std::unique_lock<std::mutex> lock(s.mutex);
+  auto found = s.cache.find(id);
+  if (found != s.cache.end()) {
+    s.order.splice(s.order.begin(), s.order, found->second.position);
+    std::shared_ptr<Tile> cached = found->second.tile;
+    s.waitReady(lock, *cached);
+    std::fill(cached->data.begin(), cached->data.end(), 0);
+    cached->dirty = true;
+    return cached;
+  }
+  auto zero = std::make_shared<Tile>();
+  zero->data.resize(s.tileElements());
+  zero->ready = zero->dirty = true;
+  s.insert(id, zero);
+  return zero;
+}
+
+void TiledMatrix::prefetch(const int tile_row, const int tile_col) const {
+  State& s = *state_;
+  if (tile_row < 0 || tile_col < 0 || tile_row >= s.tile_rows ||
+      tile_col >= s.tile_cols)
+    return;
+  const long id = static_cast<long>(tile_row) * s.tile_cols + tile_col;
+  auto loading = std::make_shared<Tile>();
+  {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.cache.count(id)) return;
+    loading->data.resize(s.tileElements());
+    s.insert(id, loading);
+    s.in_flight++;
+  }
+  State* state = &s;
+  MatrixScheduler::instance().push([state, id, loading]() {
+    bool failed = false;
+    try {
+      state->read(id, loading->data.data());
+    } catch (...) {
+      failed = true;
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    loading->failed = failed;
+    loading->ready = true;
+    if (failed) state->erase(id, loading.get());
+    state->in_flight--;
+  });
+}
+
+void TiledMatrix::flush() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->writeBack();
+}
+
+double TiledMatrix::getElement(const int row, const int col) const {
+  const State& s = *state_;
+  if (row < 0 || col < 0 || row >= s.rows || col >= s.cols)
+    throw OutOfRangeError();
+  const int t = s.tile_size;
+  return tile(row / t, col / t)->data[(row % t) * t + col % t];
+}
+
+void TiledMatrix::setElement(const int row, const int col,
+                             const double value) {
+  const State& s = *state_;
+  if (row < 0 || col < 0 || row >= s.rows || col >= s.cols)
+    throw OutOfRangeError();
+  MatrixService::doubleLegit(value);
+  const int t = s.tile_size;
+  std::shared_ptr<Tile> target = tile(row / t, col / t);
+  target->data[(row % t) * t + col % t] = value;
+  target->dirty = true;
+}
+
+TiledMatrix::operator Matrix() const {
+  Matrix result;
+  result.reserve(getRows(), getCols());
+  const int t = getTileSize();
+  std::vector<double> row(getCols());
+  for (int i = 0; i < tileRowCount(); i++) {
+    std::vector<std::shared_ptr<Tile>> tiles;
+    for (int j = 0; j < tileColCount(); j++) tiles.push_back(tile(i, j));
+    for (int r = 0; r < tileRows(i); r++) {
+      for (int j = 0; j < tileColCount(); j++) {
+        const double* source =
+            tiles[j]->data.data() + static_cast<size_t>(r) * t;
+        std::copy(source, source + tileCols(j), row.begin() + j * t);
+      }
+      result.appendRow(getCols(), row.data());
+    }
+  }
+  return result;
+}
+
+TiledMatrix TiledMatrix::Multiply(const TiledMatrix& other,
+                                  const std::string& path) const {
+  if (getCols() != other.getRows()) throw DimentionAlignmentError();
+  if (getTileSize() != other.getTileSize()) throw InputError();
+  const int t = getTileSize(), inner = tileColCount();
+  TiledMatrix result(path, getRows(), other.getCols(), t,
+                     state_->cache_tiles);
+  for (int i = 0; i < tileRowCount(); i++) {
+    for (int j = 0; j < other.tileColCount(); j++) {
+      std::shared_ptr<Tile> c = result.freshTile(i, j);
+      const int c_cols = other.tileCols(j);
+      for (int p = 0; p < inner; p++) {
+        prefetch(i, p + 1);
+        other.prefetch(p + 1, j);
+        std::shared_ptr<Tile> a = tile(i, p), b = other.tile(p, j);
+        const int depth = tileCols(p);
+        MatrixParallel::parallelFor(
+            0, tileRows(i), 2L * depth * c_cols, [&](int from, int to) {
+              for (int r = from; r < to; r++) {
+                double* c_row = c->data.data() + static_cast<size_t>(r) * t;
+                const double* a_row =
+                    a->data.data() + static_cast<size_t>(r) * t;
+                for (int q = 0; q < depth; q++) {
+                  const double* b_row =
+                      b->data.data() + static_cast<size_t>(q) * t;
+                  for (int col = 0; col < c_cols; col++)
+                    c_row[col] += a_row[q] * b_row[col];
+                }
+              }
+            });
+      }
+      // The first operand tiles of the next result tile.
+      prefetch(j + 1 < other.tileColCount() ? i : i + 1, 0);
+      other.prefetch(0, j + 1 < other.tileColCount() ? j + 1 : 0);
+    }
+  }
+  return result;
+}
+
+TiledMatrix TiledMatrix::Add(const TiledMatrix& other,
+                             const std::string& path) const {
+  if (getRows() != other.getRows() || getCols() != other.getCols())
+    throw DimentionEqualityError();
+  if (getTileSize() != other.getTileSize()) throw InputError();
+  TiledMatrix result(path, getRows(), getCols(), getTileSize(),
+                     state_->cache_tiles);
+  for (int i = 0; i < tileRowCount(); i++) {
+    for (int j = 0; j < tileColCount(); j++) {
+      const int next_i = j + 1 < tileColCount() ? i : i + 1;
+      const int next_j = j + 1 < tileColCount() ? j + 1 : 0;
+      prefetch(next_i, next_j);
+      other.prefetch(next_i, next_j);
+      std::shared_ptr<Tile> a = tile(i, j), b = other.tile(i, j);
+      std::shared_ptr<Tile> c = result.freshTile(i, j);
+      for (size_t k = 0; k < c->data.size(); k++) {
+        c->data[k] = a->data[k] + b->data[k];
+        MatrixService::doubleLegit(c->data[k]);
+      }
+    }
+  }
+  return result;
+}
+
+TiledMatrix TiledMatrix::Transpose(const std::string& path) const {
+  const int t = getTileSize();
+  TiledMatrix result(path, getCols(), getRows(), t, state_->cache_tiles);
+  for (int i = 0; i < tileRowCount(); i++) {
+    for (int j = 0; j < tileColCount(); j++) {
+      prefetch(j + 1 < tileColCount() ? i : i + 1,
+               j + 1 < tileColCount() ? j + 1 : 0);
+      std::shared_ptr<Tile> source = tile(i, j),
+                            target = result.freshTile(j, i);
+      for (int r = 0; r < tileRows(i); r++) {
+        for (int c = 0; c < tileCols(j); c++)
+          target->data[static_cast<size_t>(c) * t + r] =
+              source->data[static_cast<size_t>(r) * t + c];
+      }
+    }
+  }
+  return result;
+}
+
+void TiledMatrix::swapRows(const int row_a, const int row_b, const int skip) {
+  const int t = getTileSize();
+  for (int j = 0; j < tileColCount(); j++) {
+    if (j == skip) continue;
+    std::shared_ptr<Tile> a = tile(row_a / t, j), b = tile(row_b / t, j);
+    double* first = a->data.data() + static_cast<size_t>(row_a % t) * t;
+    std::swap_ranges(first, first + tileCols(j),
+                     b->data.data() + static_cast<size_t>(row_b % t) * t);
+    a->dirty = b->dirty = true;
+  }
+}
+
+TiledMatrix TiledMatrix::DecomposeLU(const std::string& path,
+                                     std::vector<int>& pivots) const {
+  if (getRows() != getCols()) throw SquarenessError();
+  const int n = getRows(), t = getTileSize(), count = tileRowCount();
+  TiledMatrix lu(path, n, n, t, state_->cache_tiles);
+  for (int i = 0; i < count; i++) {
+    for (int j = 0; j < count; j++) {
+      std::shared_ptr<Tile> source = tile(i, j), target = lu.freshTile(i, j);
+      target->data = source->data;
+    }
+  }
+  pivots.assign(n, 0);
+  for (int k = 0; k < count; k++) {
+    // The tile column k below the diagonal, row by row.
+    const int first = k * t, width = lu.tileCols(k), height = n - first;
+    std::vector<double> panel(static_cast<size_t>(height) * width);
+    for (int i = k; i < count; i++) {
+      std::shared_ptr<Tile> source = lu.tile(i, k);
+      for (int r = 0; r < lu.tileRows(i); r++)
+        std::copy(source->data.begin() + static_cast<size_t>(r) * t,
+                  source->data.begin() + static_cast<size_t>(r) * t + width,
+                  panel.begin() +
+                      static_cast<size_t>(i * t + r - first) * width);
+    }
+    for (int c = 0; c < width; c++) {
+      int pivot = c;
+      for (int r = c + 1; r < height; r++) {
+        if (std::fabs(panel[static_cast<size_t>(r) * width + c]) >
+            std::fabs(panel[static_cast<size_t>(pivot) * width + c]))
+          pivot = r;
+      }
+      const double pivot_value = panel[static_cast<size_t>(pivot) * width + c];
+      if (pivot_value == 0 || !std::isfinite(pivot_value))
+        throw NonInvertibleError();
+      pivots[first + c] = first + pivot;
+      if (pivot != c)
+        std::swap_ranges(panel.begin() + static_cast<size_t>(c) * width,
+                         panel.begin() + static_cast<size_t>(c + 1) * width,
+                         panel.begin() + static_cast<size_t>(pivot) * width);
+      const double* pivot_row = panel.data() + static_cast<size_t>(c) * width;
+      for (int r = c + 1; r < height; r++) {
+        double* current = panel.data() + static_cast<size_t>(r) * width;
+        const double factor = current[c] /= pivot_row[c];
+        for (int cc = c + 1; cc < width; cc++)
+          current[cc] -= factor * pivot_row[cc];
+      }
+    }
+    for (int i = k; i < count; i++) {
+      std::shared_ptr<Tile> target = lu.tile(i, k);
+      for (int r = 0; r < lu.tileRows(i); r++) {
+        const size_t row = static_cast<size_t>(i * t + r - first) * width;
+        std::copy(panel.begin() + row, panel.begin() + row + width,
+                  target->data.begin() + static_cast<size_t>(r) * t);
+      }
+      target->dirty = true;
+    }
+    for (int c = 0; c < width; c++) {
+      if (pivots[first + c] != first + c)
+        lu.swapRows(first + c, pivots[first + c], k);
+    }
+    // U_kj = L_kk^-1 * A_kj, then A_ij -= L_ik * U_kj.
+    for (int j = k + 1; j < count; j++) {
+      std::shared_ptr<Tile> u = lu.tile(k, j);
+      const int cols = lu.tileCols(j);
+      for (int r = 1; r < width; r++) {
+        double* u_row = u->data.data() + static_cast<size_t>(r) * t;
+        for (int q = 0; q < r; q++) {
+          const double l = panel[static_cast<size_t>(r) * width + q];
+          const double* u_q = u->data.data() + static_cast<size_t>(q) * t;
+          for (int c = 0; c < cols; c++) u_row[c] -= l * u_q[c];
+        }
+      }
+      u->dirty = true;
+      for (int i = k + 1; i < count; i++) {
+        lu.prefetch(i + 1, j);
+        std::shared_ptr<Tile> a = lu.tile(i, j);
+        MatrixParallel::parallelFor(
+            0, lu.tileRows(i), 2L * width * cols, [&](int from, int to) {
+              for (int r = from; r < to; r++) {
+                double* a_row = a->data.data() + static_cast<size_t>(r) * t;
+                const double* l_row =
+                    panel.data() +
+                    static_cast<size_t>(i * t + r - first) * width;
+                for (int q = 0; q < width; q++) {
+                  const double* u_q =
+                      u->data.data() + static_cast<size_t>(q) * t;
+                  for (int c = 0; c < cols; c++) a_row[c] -= l_row[q] * u_q[c];
+                }
+              }
+            });
+        a->dirty = true;
+      }
+    }
+  }
+  return lu;
+}
+
+Vector TiledMatrix::SolveLU(const std::vector<int>& pivots,
+                            const Vector& b) const {
+  if (getRows() != getCols()) throw SquarenessError();
+  const int n = getRows(), t = getTileSize(), count = tileRowCount();
+  if (static_cast<int>(pivots.size()) != n) throw InputError();
+  if (!b.getData()) throw MatrixSetError();
+  if (b.getSize() != n) throw DimentionAlignmentError();
+  std::vector<double> x(b.getData(), b.getData() + n);
+  for (int i = 0; i < n; i++) {
+    if (pivots[i] < i || pivots[i] >= n) throw InputError();
+    std::swap(x[i], x[pivots[i]]);
+  }
+  for (int i = 0; i < count; i++) {
+    double* x_i = x.data() + i * t;
+    for (int j = 0; j < i; j++) {
+      std::shared_ptr<Tile> l = tile(i, j);
+      for (int r = 0; r < tileRows(i); r++)
+        x_i[r] -= MatrixService::dotProduct(
+            l->data.data() + static_cast<size_t>(r) * t, x.data() + j * t,
+            tileCols(j));
+    }
+    std::shared_ptr<Tile> l = tile(i, i);
+    for (int r = 1; r < tileRows(i); r++)
+      x_i[r] -= MatrixService::dotProduct(
+          l->data.data() + static_cast<size_t>(r) * t, x_i, r);
+  }
+  for (int i = count - 1; i >= 0; i--) {
+    double* x_i = x.data() + i * t;
+    for (int j = i + 1; j < count; j++) {
+      std::shared_ptr<Tile> u = tile(i, j);
+      for (int r = 0; r < tileRows(i); r++)
+        x_i[r] -= MatrixService::dotProduct(
+            u->data.data() + static_cast<size_t>(r) * t, x.data() + j * t,
+            tileCols(j));
+    }
+    std::shared_ptr<Tile> u = tile(i, i);
+    for (int r = tileRows(i) - 1; r >= 0; r--) {
+      const double* u_row = u->data.data() + static_cast<size_t>(r) * t;
+      x_i[r] = (x_i[r] - MatrixService::dotProduct(u_row + r + 1, x_i + r + 1,
+                                                   tileRows(i) - r - 1)) /
+               u_row[r];
+    }
+  }
+  return Vector(n, n, x.data());
+}
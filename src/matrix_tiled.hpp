@@ -0,0 +1,231 @@
+#ifndef MATRIX_TILED
+#define MATRIX_TILED
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "matrix_cpp.hpp"
+#include "matrix_exceptions.hpp"
+#include "matrix_service.hpp"
+#include "matrix_vector.hpp"
+
+/**
+ * @brief A matrix stored in a local file as square tiles, only a bounded
+ * number of which are kept in memory.
+ * @details The file starts with a small header followed by the tiles in row
+ * major order, each one stored row by row and padded with zeros at the
+ * borders. Tiles are loaded on demand into a least recently used cache and
+ * written back when evicted or flushed; prefetch() loads a tile in the
+ * background on the shared scheduler. Tiles in use by an operation are never
+ * evicted, so operations keep at most a few tiles above the limit.
+ * @note Methods without "noexcept" keyword include verios of throws. A tiled
+ * matrix must not be used by several threads at once.
+ * @see matrix_exceptions.hpp
+ */
+class TiledMatrix {
+ public:
+  /**
+   * @brief Creates a zero matrix in a new file (an existing file is
+   * overwritten).
+   * @param path The file to store the matrix in.
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param tile_size The order of the tiles.
+   * @param cache_tiles The number of tiles kept in memory.
+   */
+  TiledMatrix(const std::string& path, const int rows, const int cols,
+              const int tile_size = TILE_SIZE,
+              const int cache_tiles = TILE_CACHE);
+  /**
+   * @brief Opens a matrix stored in an existing file.
+   * @param path The file the matrix is stored in.
+   * @param cache_tiles The number of tiles kept in memory.
+   * @throws InputError if the file can not be opened or has no valid header.
+   */
+  explicit TiledMatrix(const std::string& path,
+                       const int cache_tiles = TILE_CACHE);
+  /**
+   * @brief Stores a matrix in a new file.
+   * @param path The file to store the matrix in.
+   * @param matrix The matrix to store.
+   * @param tile_size The order of the tiles.
+   * @param cache_tiles The number of tiles kept in memory.
+   */
+  TiledMatrix(const std::string& path, const Matrix& matrix,
+              const int tile_size = TILE_SIZE,
+              const int cache_tiles = TILE_CACHE);
+  /**
+   * @brief Move constructor.
+   * @param other The matrix to move.
+   */
+  TiledMatrix(TiledMatrix&& other) noexcept;
+  /**
+   * @brief Writes the modified tiles back and closes the file.
+   */
+  ~TiledMatrix() noexcept;
+  TiledMatrix(const TiledMatrix&) = delete;
+  TiledMatrix& operator=(const TiledMatrix&) = delete;
+
+  // Getters and setters
+  /**
+   * @brief Retrieves the number of rows.
+   * @return Number of rows.
+   */
+  int getRows() const noexcept;
+  /**
+   * @brief Retrieves the number of columns.
+   * @return Number of columns.
+   */
+  int getCols() const noexcept;
+  /**
+   * @brief Retrieves the order of the tiles.
+   * @return Tile size.
+   */
+  int getTileSize() const noexcept;
+  /**
+   * @brief Retrieves the path of the file.
+   * @return The path.
+   */
+  const std::string& getPath() const noexcept;
+  /**
+   * @brief Retrieves the number of tiles read from the file so far.
+   * @return Tile reads.
+   */
+  long getTileReads() const noexcept;
+  /**
+   * @brief Retrieves the number of tiles written to the file so far.
+   * @return Tile writes.
+   */
+  long getTileWrites() const noexcept;
+  /**
+   * @brief Retrieves the number of tiles currently held in memory.
+   * @return Cached tiles.
+   */
+  int getCachedTiles() const noexcept;
+  /**
+   * @brief Retrieves an element.
+   * @param row Row index.
+   * @param col Column index.
+   * @return The element.
+   */
+  double getElement(const int row, const int col) const;
+  /**
+   * @brief Sets an element.
+   * @param row Row index.
+   * @param col Column index.
+   * @param value The new value.
+   */
+  void setElement(const int row, const int col, const double value);
+
+  // Service functions
+  /**
+   * @brief Starts loading a tile in the background.
+   * @param tile_row Row index of the tile.
+   * @param tile_col Column index of the tile.
+   */
+  void prefetch(const int tile_row, const int tile_col) const;
+  /**
+   * @brief Writes every modified tile back to the file.
+   */
+  void flush() const;
+  /**
+   * @brief Loads the whole matrix into memory.
+   * @return The matrix.
+   */
+  operator Matrix() const;
+
+  // Operations
+  /**
+   * @brief Multiplies the matrix by another one tile by tile.
+   * @details Every tile of the result is accumulated in memory while the
+   * next pair of operand tiles is prefetched.
+   * @param other The matrix to multiply by (with the same tile size).
+   * @param path The file for the result.
+   * @return The product.
+   */
+  TiledMatrix Multiply(const TiledMatrix& other,
+                       const std::string& path) const;
+  /**
+   * @brief Adds another matrix tile by tile.
+   * @param other The matrix to add (with the same tile size).
+   * @param path The file for the result.
+   * @return The sum.
+   */
+  TiledMatrix Add(const TiledMatrix& other, const std::string& path) const;
+  /**
+   * @brief Transposes the matrix tile by tile.
+   * @param path The file for the result.
+   * @return The transposed matrix.
+   */
+  TiledMatrix Transpose(const std::string& path) const;
+  /**
+   * @brief Calculates the LU decomposition with partial pivoting
+   * (P * A = L * U) by tile columns.
+   * @details The tile column being factorized is kept in memory (n * tile
+   * elements), the trailing tiles are updated one at a time.
+   * @param path The file for the factors (L with a unit diagonal and U packed
+   * together).
+   * @param pivots Output parameter: the row swapped with row i at step i.
+   * @return The packed factors.
+   */
+  TiledMatrix DecomposeLU(const std::string& path,
+                          std::vector<int>& pivots) const;
+  /**
+   * @brief Solves A * x = b with factors computed by DecomposeLU().
+   * @param pivots The row swaps of the decomposition.
+   * @param b The right hand side.
+   * @return The solution.
+   */
+  Vector SolveLU(const std::vector<int>& pivots, const Vector& b) const;
+
+ private:
+  struct Tile;
+  struct State;
+  std::unique_ptr<State> state_;  ///< The file and the tile cache.
+
+  /**
+   * @brief Retrieves a tile, loading it if it is not cached.
+   * @param tile_row Row index of the tile.
+   * @param tile_col Column index of the tile.
+   * @return The tile, which stays in memory while it is referenced.
+   */
+  std::shared_ptr<Tile> tile(const int tile_row, const int tile_col) const;
+  /**
+   * @brief Retrieves a tile that is about to be overwritten: its elements are
+   * zero-filled in memory instead of being read from the file.
+   * @param tile_row Row index of the tile.
+   * @param tile_col Column index of the tile.
+   * @return The zero tile, marked as modified.
+   */
+  std::shared_ptr<Tile> freshTile(const int tile_row, const int tile_col);
+  /**
+   * @brief Swaps two rows in every tile column but one.
+   * @param row_a The first row.
+   * @param row_b The second row.
+   * @param skip The tile column left untouched.
+   */
+  void swapRows(const int row_a, const int row_b, const int skip);
+  /**
+   * @brief Retrieves the number of rows stored in a tile row.
+   * @param tile_row Row index of the tile.
+   * @return Number of rows of the tile.
+   */
+  int tileRows(const int tile_row) const noexcept;
+  /**
+   * @brief Retrieves the number of columns stored in a tile column.
+   * @param tile_col Column index of the tile.
+   * @return Number of columns of the tile.
+   */
+  int tileCols(const int tile_col) const noexcept;
+  /**
+   * @brief Retrieves the number of tile rows.
+   * @return Tile rows.
+   */
+  int tileRowCount() const noexcept;
+  /**
+   * @brief Retrieves the number of tile columns.
+   * @return Tile columns.
+   */
+  int tileColCount() const noexcept;
+};
+#endif  // MATRIX_TILED
@@ -0,0 +1,152 @@
+#include "matrix_tuning.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+/**
+ * @brief The configuration in use, readable from any thread.
+ */
+struct TuningState {
+  std::atomic<int> transpose_block;
+  std::atomic<int> multiply_block;
+  std::atomic<long> parallel_grain;
+  std::atomic<int> blas_order;
+
+  /**
+   * @brief Loads the configuration of the local host, if there is one.
+   */
+  TuningState() {
+    TuningConfig config;
+    try {
+      const std::string path = MatrixTuning::defaultPath();
+      if (!path.empty()) MatrixTuning::load(path, config);
+    } catch (...) {
+    }
+    transpose_block = config.transpose_block;
+    multiply_block = config.multiply_block;
+    parallel_grain = config.parallel_grain;
+    blas_order = config.blas_order;
+  }
+};
+
+/**
+ * @brief Retrieves the configuration state, loading it on first use.
+ * @return Reference to the state.
+ */
+static TuningState& state() noexcept {
+  static TuningState current;
+  return current;
+}
+
+/**
+ * @brief Removes the blanks around a string.
+ * @param text The string.
+ * @return The trimmed string.
+ */
+static std::string trim(const std::string& text) {
+  const size_t first = text.find_first_not_of(" \t\r");
+  if (first == std::string::npos) return std::string();
+  return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+/**
+ * @brief Parses a positive integer.
+ * @param text The number.
+ * @param value Output parameter: the number, untouched if it is invalid.
+ */
+template <typename T>
+static void parsePositive(const std::string& text, T& value) {
+  try {
+    size_t end = 0;
+    const long long number = std::stoll(text, &end);
+    if (end == text.size() && number > 0) value = static_cast<T>(number);
+  } catch (...) {
+  }
+}
+
+TuningConfig MatrixTuning::get() noexcept {
+  const TuningState& current = state();
+  TuningConfig config;
+  config.transpose_block = current.transpose_block.load();
+  config.multiply_block = current.multiply_block.load();
+  config.parallel_grain = current.parallel_grain.load();
+  config.blas_order = current.blas_order.load();
+  return config;
+}
+
+void MatrixTuning::set(const TuningConfig& config) noexcept {
+  const TuningConfig defaults;
+  TuningState& current = state();
+  current.transpose_block = config.transpose_block > 0
+                                ? config.transpose_block
+                                : defaults.transpose_block;
+  current.multiply_block = config.multiply_block > 0 ? config.multiply_block
+                                                     : defaults.multiply_block;
+  current.parallel_grain = config.parallel_grain > 0 ? config.parallel_grain
+                                                     : defaults.parallel_grain;
+  current.blas_order =
+      config.blas_order > 0 ? config.blas_order : defaults.blas_order;
+}
+
+std::string MatrixTuning::defaultPath() {
+  const char* file = std::getenv("MATRIX_TUNE_FILE");
+  if (file) return file;
+  const char* home = std::getenv("HOME");
+  return home ? std::string(home) + "/.matrix_tune.conf" : std::string();
+}
+
+std::string MatrixTuning::hostName() {
+  std::string model = "unknown";
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  for (std::string line; std::getline(cpuinfo, line);) {
+    const size_t colon = line.find(':');
+    if (colon != std::string::npos &&
+        trim(line.substr(0, colon)) == "model name") {
+      model = trim(line.substr(colon + 1));
+      break;
+    }
+  }
+  const unsigned threads = std::thread::hardware_concurrency();
+  return model + " x" + std::to_string(threads ? threads : 1);
+}
+
+bool MatrixTuning::load(const std::string& path, TuningConfig& config) {
+  std::ifstream file(path);
+  if (!file) return false;
+  TuningConfig loaded = config;
+  bool same_host = false;
+  for (std::string line; std::getline(file, line);) {
+    line = trim(line);
+    const size_t equal = line.find('=');
+    if (line.empty() || line[0] == '#' || equal == std::string::npos) continue;
+    const std::string key = trim(line.substr(0, equal));
+    const std::string value = trim(line.substr(equal + 1));
+    if (key == "host") {
+      same_host = value == hostName();
+    } else if (key == "transpose_block") {
+      parsePositive(value, loaded.transpose_block);
+    } else if (key == "multiply_block") {
+      parsePositive(value, loaded.multiply_block);
+    } else if (key == "parallel_grain") {
+      parsePositive(value, loaded.parallel_grain);
+    } else if (key == "blas_order") {
+      parsePositive(value, loaded.blas_order);
+    }
+  }
+  if (same_host) config = loaded;
+  return same_host;
+}
+
+bool MatrixTuning::save(const std::string& path, const TuningConfig& config) {
+  std::ofstream file(path, std::ios::trunc);
+  file << "# Kernel configuration written by matrix_tune\n"
+       << "host = " << hostName() << "\n"
+       << "transpose_block = " << config.transpose_block << "\n"
+       << "multiply_block = " << config.multiply_block << "\n"
+       << "parallel_grain = " << config.parallel_grain << "\n"
+       << "blas_order = " << config.blas_order << "\n";
+  file.flush();
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,67 @@
+#ifndef MATRIX_TUNING
+#define MATRIX_TUNING
+#include <string>
+
+#include "matrix_service.hpp"
+
+/**
+ * @brief The block sizes and thresholds of the kernels.
+ */
+struct TuningConfig {
+  int transpose_block = TRANSPOSE_BLOCK;  ///< Tile of the blocked transpose.
+  int multiply_block = MULTIPLY_BLOCK;    ///< Depth of the product panels.
+  long parallel_grain = PARALLEL_GRAIN;   ///< Work per extra thread.
+  int blas_order = BLAS_ORDER;            ///< Order using the BLAS backend.
+};
+
+/**
+ * @brief Provides the kernel configuration tuned for the local host.
+ * @details On first use the configuration is loaded from the file named by
+ * the MATRIX_TUNE_FILE environment variable (by default ~/.matrix_tune.conf),
+ * which is written by the matrix_tune tool of the Makefile. A missing file,
+ * a file tuned on another CPU model and invalid entries fall back to the
+ * compiled defaults.
+ */
+namespace MatrixTuning {
+  /**
+   * @brief Retrieves the current configuration.
+   * @return A copy of the configuration.
+   */
+  TuningConfig get() noexcept;
+  /**
+   * @brief Replaces the current configuration (values that are not positive
+   * are replaced with the defaults).
+   * @param config The configuration.
+   */
+  void set(const TuningConfig& config) noexcept;
+  /**
+   * @brief Retrieves the path of the configuration file.
+   * @return The path (empty if neither MATRIX_TUNE_FILE nor HOME is set).
+   */
+  std::string defaultPath();
+  /**
+   * @brief Describes the local CPU: its model name and thread count.
+   * @return The description.
+   */
+  std::string hostName();
+  /**
+   * @brief Reads a configuration file written for the local host.
+   * @details The file consists of "key = value" lines; empty lines and lines
+   * starting with '#' are skipped, unknown keys and invalid values are
+   * ignored.
+   * @param path The file.
+   * @param config Output parameter: the configuration, entries missing from
+   * the file keep their values.
+   * @return True if the file was read and its "host" entry matches
+   * hostName(), config is left untouched otherwise.
+   */
+  bool load(const std::string& path, TuningConfig& config);
+  /**
+   * @brief Writes a configuration file for the local host.
+   * @param path The file.
+   * @param config The configuration.
+   * @return True if the file was written.
+   */
+  bool save(const std::string& path, const TuningConfig& config);
+}
+#endif  // MATRIX_TUNING
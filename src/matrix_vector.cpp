@@ -0,0 +1,127 @@
+#include "matrix_vector.hpp"
+
+#include <algorithm>
+
+#include "matrix_numa.hpp"
+#include "matrix_parallel.hpp"
+
+Vector::Vector(const int size) {
+  if (size <= 0) throw DimentionError();
+  size_ = size;
+  allocateVector();
+}
+
+Vector::Vector(const Vector& other) : size_(other.size_) {
+  if (other.data_) {
+    allocateVector();
+    std::copy(other.data_, other.data_ + size_, data_);
+  }
+}
+
+Vector::~Vector() noexcept {
+  MatrixNuma::deallocate(data_);
+  setNullVector();
+}
+
+void Vector::allocateVector() {
+  data_ = MatrixNuma::allocate(size_, size_);
+  if (!data_) throw MemoryAllocationError();
+}
+
+void Vector::setNullVector() noexcept {
+  size_ = 0;
+  data_ = nullptr;
+}
+
+void Vector::validateData() const {
+  for (int i = 0; i < size_; i++) MatrixService::doubleLegit(data_[i]);
+}
+
+void Vector::setVector(const int n, const double array[]) {
+  if (!data_) throw MatrixSetError();
+  if (n < 0 || !array) throw InputError();
+  if (n > size_) throw OutOfRangeError();
+  for (int i = 0; i < n; i++) MatrixService::doubleLegit(array[i]);
+  std::copy(array, array + n, data_);
+  std::fill(data_ + n, data_ + size_, 0);
+}
+
+Vector& Vector::operator=(const Vector& other) {
+  if (this != &other) {
+    Vector copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+Vector& Vector::operator=(Vector&& other) noexcept {
+  if (this != &other) {
+    MatrixNuma::deallocate(data_);
+    size_ = other.size_;
+    data_ = other.data_;
+    other.setNullVector();
+  }
+  return *this;
+}
+
+bool Vector::EqVector(const Vector& other) const {
+  if (!data_ || !other.data_) throw MatrixSetError();
+  bool output = size_ == other.size_;
+  for (int i = 0; output && i < size_; i++) {
+    if (data_[i] != other.data_[i])
+      output = MatrixService::doubleEqComplex(data_[i], other.data_[i]);
+  }
+  return output;
+}
+
+double Vector::Dot(const Vector& other) const {
+  if (!data_ || !other.data_) throw MatrixSetError();
+  if (size_ != other.size_) throw DimentionEqualityError();
+  const double sum =
+      MatrixParallel::parallelSum(0, size_, 2, [&](int from, int to) {
+        return MatrixService::dotProduct(data_ + from, other.data_ + from,
+                                         to - from);
+      });
+  MatrixService::doubleLegit(sum);
+  return sum;
+}
+
+void Vector::Axpy(const double alpha, const Vector& x) {
+  if (!data_ || !x.data_) throw MatrixSetError();
+  if (size_ != x.size_) throw DimentionEqualityError();
+  MatrixService::doubleLegit(alpha);
+  x.validateData();
+  double* y = data_;
+  const double* source = x.data_;
+  MatrixParallel::parallelFor(0, size_, 2, [=](int from, int to) {
+    for (int i = from; i < to; i++) y[i] += alpha * source[i];
+  });
+}
+
+double Vector::NormOne() const {
+  if (!data_) throw MatrixSetError();
+  double norm = 0;
+  for (int i = 0; i < size_; i++) norm += fabs(data_[i]);
+  MatrixService::doubleLegit(norm);
+  return norm;
+}
+
+double Vector::NormTwo() const {
+  if (!data_) throw MatrixSetError();
+  const double norm_inf = NormInf();
+  if (norm_inf == 0) return 0;
+  double sum = 0;
+  for (int i = 0; i < size_; i++) {
+    const double scaled = data_[i] / norm_inf;
+    sum += scaled * scaled;
+  }
+  return norm_inf * sqrt(sum);
+}
+
+double Vector::NormInf() const {
+  if (!data_) throw MatrixSetError();
+  validateData();
+  double norm = 0;
+  for (int i = 0; i < size_; i++) norm = std::max(norm, fabs(data_[i]));
+  return norm;
+}
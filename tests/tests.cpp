@@ -1,6 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+#include "../src/matrix_async.hpp"
+#include "../src/matrix_blas.hpp"
 #include "../src/matrix_cpp.hpp"
+#include "../src/matrix_numa.hpp"
+#include "../src/matrix_structured.hpp"
+#include "../src/matrix_tiled.hpp"
+#include "../src/matrix_tuning.hpp"
 using std::cout, std::cin, std::endl;
 // elevator    begining
 
@@ -930,6 +943,1422 @@ TEST(MatrixTest, SingularMatrix) {
   EXPECT_EQ(mat4 == mat5, true);
 }
 
+TEST(MatrixTest, LowRankUpdate) {
+  double ar[]{2, 5, 0, 4, 8, 0, 1, 5, 10};
+  double ar_u[]{1, 0, 2};
+  double ar_v[]{0.5, -1, 1};
+  Matrix matrix(3, 3, 9, ar), u(3, 1, 3, ar_u), v(3, 1, 3, ar_v);
+  Matrix inverse = matrix.InverseMatrix();
+  double det = matrix.Determinant();
+  matrix.LowRankUpdate(u, v, inverse, det);
+  Matrix expected(3, 3, 9, ar);
+  expected += u * v.Transpose();
+  EXPECT_EQ(matrix == expected, true);
+  EXPECT_EQ(inverse == expected.InverseMatrix(), true);
+  EXPECT_NEAR(det, expected.Determinant(), EPSILON);
+}
+TEST(MatrixTest, LowRankUpdate_2) {
+  double ar[]{1, 2, 0, 5, 0, 1, -5, 0.5, 0, 0, 0, 2, 1, 0, 0, 1};
+  double ar_u[]{1, 0, 0, 2, -1, 1, 0.5, 0};
+  double ar_v[]{0, 1, 1, 0, 2, 0, 0, 3};
+  Matrix matrix(4, 4, 16, ar), u(4, 2, 8, ar_u), v(4, 2, 8, ar_v);
+  Matrix inverse = matrix.InverseMatrix();
+  double det = matrix.Determinant();
+  matrix.LowRankUpdate(u, v, inverse, det);
+  Matrix expected = Matrix(4, 4, 16, ar) + u * v.Transpose();
+  EXPECT_EQ(inverse == expected.InverseMatrix(), true);
+  EXPECT_NEAR(det, expected.Determinant(), EPSILON);
+}
+TEST(MatrixTest, LowRankUpdate_Fallback) {
+  double ar[]{1, 0, 0, 1};
+  double ar_u[]{-1, 0};
+  double ar_v[]{1, 0};
+  Matrix matrix(2, 2, 4, ar), u(2, 1, 2, ar_u), v(2, 1, 2, ar_v);
+  Matrix inverse = matrix.InverseMatrix();
+  double det = 1;
+  EXPECT_THROW(matrix.LowRankUpdate(u, v, inverse, det), NonInvertibleError);
+  EXPECT_EQ(matrix(0, 0), 1);
+  inverse *= 2;
+  v(0, 0) = 0.5;
+  matrix.LowRankUpdate(u, v, inverse, det);
+  EXPECT_EQ(inverse == matrix.InverseMatrix(), true);
+  EXPECT_NEAR(det, 0.5, EPSILON);
+}
+TEST(MatrixTest, LowRankUpdate_Exception) {
+  Matrix matrix(3, 3), inverse(3, 3), u(3, 1), v(2, 1), empty;
+  double det = 1;
+  EXPECT_THROW(matrix.LowRankUpdate(u, v, inverse, det),
+               DimentionEqualityError);
+  EXPECT_THROW(matrix.LowRankUpdate(u, empty, inverse, det), MatrixSetError);
+  Matrix rect(3, 2);
+  EXPECT_THROW(rect.LowRankUpdate(u, u, inverse, det), SquarenessError);
+  Matrix u_2(2, 1);
+  EXPECT_THROW(matrix.LowRankUpdate(u_2, u_2, inverse, det),
+               DimentionAlignmentError);
+}
+
+TEST(MatrixTest, TransposeView) {
+  double ar[]{1.1, 2, 3, 8.9, 4.005, 5.666, 6, -5, 7.000001, 8, 9, 999};
+  int n = sizeof(ar) / sizeof(ar[0]);
+  int a = 3, b = 4;
+  Matrix matrix(a, b, n, ar);
+  Matrix::TransposedMatrix view = matrix.Transpose();
+  EXPECT_EQ(view.getRows(), b);
+  EXPECT_EQ(view.getCols(), a);
+  EXPECT_EQ(view.getElement(3, 2), 999);
+  EXPECT_THROW(view.getElement(2, 3), OutOfRangeError);
+  matrix(2, 3) = 5;
+  EXPECT_EQ(view.getElement(3, 2), 5);
+}
+TEST(MatrixTest, TransposeProducts) {
+  double ar[]{1.1, 2, 3, 8.9, 4.005, 5.666, 6, -5, 7.000001, 8, 9, 999};
+  double ar2[]{1, 0, -2, 3, 0.5, 4, 7, -1, 2, 2, 0, 1};
+  int n = sizeof(ar) / sizeof(ar[0]);
+  Matrix m_a(3, 4, n, ar), m_b(3, 4, n, ar2);
+  Matrix a_t = m_a.Transpose(), b_t = m_b.Transpose();
+  EXPECT_EQ(m_a * m_b.Transpose() == m_a * b_t, true);
+  EXPECT_EQ(m_a.Transpose() * m_b == a_t * m_b, true);
+  EXPECT_EQ(m_a.Transpose() * b_t.Transpose() == a_t * m_b, true);
+  EXPECT_EQ(b_t.Transpose() * m_a.Transpose() == m_b * a_t, true);
+  Matrix gram = m_a.Transpose() * m_a;
+  EXPECT_EQ(gram == a_t * m_a, true);
+  EXPECT_EQ(gram.getRows(), 4);
+  EXPECT_EQ(m_a * m_a.Transpose() == m_a * a_t, true);
+  EXPECT_THROW(m_a.Transpose() * b_t, DimentionAlignmentError);
+  EXPECT_EQ(m_b.Transpose() * 2 == b_t * 2, true);
+}
+
+TEST(VectorTest, Constructors) {
+  double ar[]{1, -2, 3};
+  Vector vector(4, 3, ar);
+  EXPECT_EQ(vector.getSize(), 4);
+  EXPECT_EQ(vector.getElement(1), -2);
+  EXPECT_EQ(vector.getElement(3), 0);
+  Vector copy(vector);
+  EXPECT_EQ(copy == vector, true);
+  Vector moved = std::move(copy);
+  EXPECT_EQ(copy.getData(), nullptr);
+  EXPECT_EQ(moved[2], 3);
+  EXPECT_THROW(Vector(0), DimentionError);
+  EXPECT_THROW(Vector(2, 3, ar), OutOfRangeError);
+  EXPECT_THROW(vector.getElement(4), OutOfRangeError);
+  EXPECT_THROW(vector.setElement(0, NAN), DataError);
+}
+TEST(VectorTest, DotAxpyNorms) {
+  double ar[]{3, -4, 0};
+  double ar2[]{1, 2, 5};
+  Vector x(3, 3, ar), y(3, 3, ar2);
+  EXPECT_EQ(x.Dot(y), -5);
+  EXPECT_EQ(x.NormOne(), 7);
+  EXPECT_EQ(x.NormTwo(), 5);
+  EXPECT_EQ(x.NormInf(), 4);
+  y.Axpy(2, x);
+  EXPECT_EQ(y.getElement(0), 7);
+  EXPECT_EQ(y.getElement(1), -6);
+  EXPECT_EQ(y.getElement(2), 5);
+  Vector z(4), empty;
+  EXPECT_THROW(x.Dot(z), DimentionEqualityError);
+  EXPECT_THROW(z.Axpy(1, x), DimentionEqualityError);
+  EXPECT_THROW(empty.NormTwo(), MatrixSetError);
+}
+TEST(VectorTest, Gemv) {
+  double ar[]{1, 2, 3, 4, 5, 6};
+  double ar_x[]{1, 0, -1};
+  double ar_y[]{1, 1};
+  Matrix matrix(2, 3, 6, ar);
+  Vector x(3, 3, ar_x), y(2, 2, ar_y);
+  Vector result = matrix * x;
+  EXPECT_EQ(result.getElement(0), -2);
+  EXPECT_EQ(result.getElement(1), -2);
+  matrix.Gemv(2, x, 3, y);
+  EXPECT_EQ(y.getElement(0), -1);
+  EXPECT_EQ(y.getElement(1), -1);
+  Vector result_t = matrix.Transpose() * y;
+  EXPECT_EQ(result_t.getElement(0), -5);
+  EXPECT_EQ(result_t.getElement(2), -9);
+  EXPECT_THROW(matrix * y, DimentionAlignmentError);
+  EXPECT_THROW(matrix.Transpose() * x, DimentionAlignmentError);
+  Matrix empty;
+  EXPECT_THROW(empty.Gemv(1, x, 0, y), MatrixSetError);
+  double big[]{1e308};
+  Matrix huge(1, 3, 1, big);
+  EXPECT_THROW(huge * Vector(3, 1, big), DataError);
+}
+TEST(VectorTest, Gemv_Parallel) {
+  const int size = 600;
+  Matrix matrix(size, size);
+  Vector x(size);
+  for (int i = 0; i < size; i++) {
+    x[i] = i % 7 - 3;
+    for (int j = 0; j < size; j++) matrix(i, j) = (i + 2 * j) % 5;
+  }
+  Vector y = matrix * x, y_t = matrix.Transpose() * x;
+  for (int i = 0; i < size; i += 37) {
+    double sum = 0, sum_t = 0;
+    for (int j = 0; j < size; j++) {
+      sum += matrix(i, j) * x[j];
+      sum_t += matrix(j, i) * x[j];
+    }
+    EXPECT_EQ(y[i], sum);
+    EXPECT_EQ(y_t[i], sum_t);
+  }
+  EXPECT_NEAR(x.Dot(x), x.NormTwo() * x.NormTwo(), 1e-9);
+}
+
+TEST(MatrixTest, setDimentions_Shrink) {
+  double ar[]{1, 2, 3, 8, 4, 5, 6, -5, 7, 8, 9, 999};
+  int n = sizeof(ar) / sizeof(ar[0]);
+  int a = 3, b = 4;
+  Matrix matrix(a, b, n, ar);
+  const double** storage = matrix.getMatrix();
+  matrix.setDimentions(2, 2);
+  EXPECT_EQ(matrix.getRows(), 2);
+  EXPECT_EQ(matrix.getCols(), 2);
+  EXPECT_EQ(matrix.getElement(1, 1), 5);
+  EXPECT_THROW(matrix.getElement(2, 0), OutOfRangeError);
+  matrix.setDimentions(3, 4);
+  EXPECT_EQ(matrix.getMatrix(), storage);
+  EXPECT_EQ(matrix.getElement(1, 1), 5);
+  EXPECT_EQ(matrix.getElement(1, 3), 0);
+  EXPECT_EQ(matrix.getElement(2, 0), 0);
+  matrix.shrink_to_fit();
+  EXPECT_EQ(matrix.getRowCapacity(), 3);
+  EXPECT_EQ(matrix.getColCapacity(), 4);
+  EXPECT_EQ(matrix.getElement(0, 1), 2);
+  // Padded rows of a fresh matrix are kept as they are.
+  Matrix square(5, 5), tall(40, 5);
+  const double *square_data = square.getData(), *tall_data = tall.getData();
+  square.shrink_to_fit();
+  tall.shrink_to_fit();
+  tall.shrink_to_fit();
+  EXPECT_EQ(square.getData(), square_data);
+  EXPECT_EQ(tall.getData(), tall_data);
+  tall.setDimentions(20, 3);
+  tall.shrink_to_fit();
+  EXPECT_NE(tall.getData(), tall_data);
+  tall_data = tall.getData();
+  tall.shrink_to_fit();
+  EXPECT_EQ(tall.getData(), tall_data);
+}
+TEST(MatrixTest, reserve) {
+  Matrix matrix;
+  matrix.reserve(10, 6);
+  EXPECT_EQ(matrix.getMatrix(), nullptr);
+  double ar[]{1, 2, 3, 4};
+  matrix.appendRow(4, ar);
+  const double** storage = matrix.getMatrix();
+  EXPECT_EQ(matrix.getRows(), 1);
+  EXPECT_EQ(matrix.getCols(), 4);
+  EXPECT_EQ(matrix.getRowCapacity(), 10);
+  EXPECT_GE(matrix.getColCapacity(), 6);
+  matrix.setDimentions(10, 6);
+  EXPECT_EQ(matrix.getMatrix(), storage);
+  EXPECT_EQ(matrix.getElement(0, 3), 4);
+  EXPECT_EQ(matrix.getElement(0, 5), 0);
+  matrix.reserve(2, 2);
+  EXPECT_EQ(matrix.getRowCapacity(), 10);
+  matrix.reserve(12, 6);
+  EXPECT_EQ(matrix.getRowCapacity(), 12);
+  EXPECT_EQ(matrix.getElement(0, 2), 3);
+  EXPECT_THROW(matrix.reserve(0, 5), OutOfRangeError);
+}
+TEST(MatrixTest, appendRow) {
+  Matrix matrix;
+  double ar[]{1, 2, 3};
+  for (int i = 0; i < 100; i++) {
+    ar[0] = i;
+    matrix.appendRow(3, ar);
+  }
+  EXPECT_EQ(matrix.getRows(), 100);
+  EXPECT_EQ(matrix.getCols(), 3);
+  EXPECT_GE(matrix.getRowCapacity(), 100);
+  EXPECT_LT(matrix.getRowCapacity(), 200);
+  EXPECT_EQ(matrix.getElement(57, 0), 57);
+  EXPECT_EQ(matrix.getElement(99, 2), 3);
+  matrix.appendRow(1, ar);
+  EXPECT_EQ(matrix.getElement(100, 0), 99);
+  EXPECT_EQ(matrix.getElement(100, 1), 0);
+  EXPECT_THROW(matrix.appendRow(4, ar), OutOfRangeError);
+  EXPECT_THROW(matrix.appendRow(0, ar), InputError);
+  ar[1] = NAN;
+  EXPECT_THROW(matrix.appendRow(3, ar), DataError);
+  EXPECT_EQ(matrix.getRows(), 101);
+}
+
+TEST(MatrixTest, TrySetters) {
+  double ar[]{1, 2, 3, 8, 4, 5, 6, -5, 7, 8, 9, 999};
+  int n = sizeof(ar) / sizeof(ar[0]);
+  Matrix matrix(3, 4), empty;
+  EXPECT_EQ(matrix.trySetMatrix(n, ar), MatrixStatus::Ok);
+  EXPECT_EQ(matrix.getElement(2, 3), 999);
+  EXPECT_EQ(matrix.trySetElement(1, 1, -1), MatrixStatus::Ok);
+  EXPECT_EQ(matrix.getElement(1, 1), -1);
+  EXPECT_EQ(matrix.trySetElement(3, 1, 1), MatrixStatus::OutOfRangeError);
+  EXPECT_EQ(matrix.trySetElement(1, 1, NAN), MatrixStatus::DataError);
+  EXPECT_EQ(matrix.getElement(1, 1), -1);
+  EXPECT_EQ(empty.trySetMatrix(n, ar), MatrixStatus::MatrixSetError);
+  EXPECT_EQ(matrix.trySetMatrix(-1, ar), MatrixStatus::InputError);
+  EXPECT_EQ(matrix.trySetMatrix(13, ar), MatrixStatus::OutOfRangeError);
+  ar[11] = INFINITY;
+  EXPECT_EQ(matrix.trySetMatrix(n, ar), MatrixStatus::DataError);
+  EXPECT_EQ(matrix.getElement(2, 3), 999);
+  EXPECT_EQ(matrix.trySetDimentions(0, 4), MatrixStatus::OutOfRangeError);
+  EXPECT_EQ(matrix.trySetDimentions(4, 4), MatrixStatus::Ok);
+  EXPECT_EQ(matrix.getRows(), 4);
+}
+TEST(MatrixTest, TryArithmetic) {
+  double ar[]{1, 2, 3, 3, 2, 1, 2, 1, 3};
+  Matrix matrix(3, 3, 9, ar), other(3, 3, 9, ar), rect(2, 3), empty;
+  EXPECT_EQ(matrix.TrySumMatrix(other), MatrixStatus::Ok);
+  EXPECT_EQ(matrix(2, 2), 6);
+  EXPECT_EQ(matrix.TrySubMatrix(other), MatrixStatus::Ok);
+  EXPECT_EQ(matrix == other, true);
+  EXPECT_EQ(matrix.TrySumMatrix(rect), MatrixStatus::DimentionEqualityError);
+  EXPECT_EQ(matrix.TrySubMatrix(empty), MatrixStatus::MatrixSetError);
+  EXPECT_EQ(matrix.TryMulNumber(2), MatrixStatus::Ok);
+  EXPECT_EQ(matrix(0, 1), 4);
+  EXPECT_EQ(matrix.TryMulNumber(NAN), MatrixStatus::DataError);
+  EXPECT_EQ(matrix(0, 1), 4);
+  EXPECT_EQ(rect.TryMulMatrix(other), MatrixStatus::Ok);
+  EXPECT_EQ(matrix.TryMulMatrix(rect), MatrixStatus::DimentionAlignmentError);
+  EXPECT_EQ(matrix.TryMulMatrix(other), MatrixStatus::Ok);
+  EXPECT_EQ(matrix(0, 0), 2 * 13);
+}
+TEST(MatrixTest, TryDeterminantInverse) {
+  double ar[]{2, 5, 0, 4, 8, 0, 1, 5, 10};
+  Matrix matrix(3, 3, 9, ar), inverse, rect(2, 3), singular(3, 3);
+  double det = 0;
+  EXPECT_EQ(matrix.TryDeterminant(det), MatrixStatus::Ok);
+  EXPECT_EQ(det, matrix.Determinant());
+  EXPECT_EQ(matrix.TryInverseMatrix(inverse), MatrixStatus::Ok);
+  EXPECT_EQ(inverse == matrix.InverseMatrix(), true);
+  EXPECT_EQ(rect.TryDeterminant(det), MatrixStatus::SquarenessError);
+  EXPECT_EQ(singular.TryInverseMatrix(inverse),
+            MatrixStatus::NonInvertibleError);
+  EXPECT_EQ(inverse == matrix.InverseMatrix(), true);
+  EXPECT_EQ(Matrix().TryDeterminant(det), MatrixStatus::MatrixSetError);
+  // Larger matrices are inverted through the LU decomposition.
+  Matrix large(12, 12), large_singular(12, 12);
+  for (int i = 0; i < 12; i++) {
+    for (int j = 0; j < 12; j++) {
+      large(i, j) = (i * 5 + j * 3) % 7 + (i == j ? 20 : 0);
+      large_singular(i, j) = i * j;
+    }
+  }
+  EXPECT_EQ(large.TryInverseMatrix(inverse), MatrixStatus::Ok);
+  EXPECT_EQ(inverse == large.InverseMatrix(), true);
+  EXPECT_NEAR((large * inverse)(3, 3), 1, 1e-12);
+  EXPECT_EQ(large_singular.TryInverseMatrix(inverse),
+            MatrixStatus::NonInvertibleError);
+  EXPECT_THROW(throwMatrixStatus(MatrixStatus::DataError), DataError);
+  EXPECT_NO_THROW(throwMatrixStatus(MatrixStatus::Ok));
+  try {
+    throwMatrixStatus(MatrixStatus::NonInvertibleError);
+  } catch (const MatrixError& error) {
+    EXPECT_EQ(error.status(), MatrixStatus::NonInvertibleError);
+  }
+}
+
+TEST(MatrixTest, getVersion) {
+  double ar[]{1, 2, 3, 3, 2, 1, 2, 1, 3};
+  Matrix matrix(3, 3, 9, ar), other(3, 3);
+  unsigned long version = matrix.getVersion();
+  matrix.setElement(0, 0, 5);
+  EXPECT_GT(matrix.getVersion(), version);
+  version = matrix.getVersion();
+  matrix(1, 1) = 7;
+  EXPECT_GT(matrix.getVersion(), version);
+  version = matrix.getVersion();
+  matrix += other;
+  EXPECT_GT(matrix.getVersion(), version);
+  version = matrix.getVersion();
+  matrix.setMatrix(9, ar);
+  EXPECT_GT(matrix.getVersion(), version);
+  version = matrix.getVersion();
+  matrix.getElement(0, 0);
+  matrix.Determinant();
+  EXPECT_EQ(matrix.getVersion(), version);
+}
+TEST(MatrixTest, getHash) {
+  double ar[]{1, 2, 3, 3, 2, 1, 2, 1, 3};
+  Matrix matrix(3, 3, 9, ar), same(3, 3, 9, ar), shape(1, 9, 9, ar), empty;
+  EXPECT_EQ(matrix.getHash(), same.getHash());
+  EXPECT_NE(matrix.getHash(), shape.getHash());
+  same(2, 2) = 3.0000001;
+  EXPECT_NE(matrix.getHash(), same.getHash());
+  EXPECT_EQ(empty.getHash(), 0u);
+}
+TEST(MatrixTest, setCaching) {
+  double ar[]{2, 5, 0, 4, 8, 0, 1, 5, 10};
+  Matrix matrix(3, 3, 9, ar);
+  EXPECT_EQ(matrix.getCaching(), false);
+  matrix.setCaching(true);
+  EXPECT_EQ(matrix.getCaching(), true);
+  double det = matrix.Determinant();
+  Matrix inverse = matrix.InverseMatrix();
+  double** raw = const_cast<double**>(matrix.getMatrix());
+  raw[0][0] = 3;
+  EXPECT_EQ(matrix.Determinant(), det);
+  EXPECT_EQ(matrix.InverseMatrix() == inverse, true);
+  matrix(0, 0) = 3;
+  EXPECT_NE(matrix.Determinant(), det);
+  EXPECT_EQ(matrix.InverseMatrix() == inverse, false);
+  Matrix copy(matrix), moved(std::move(matrix));
+  EXPECT_EQ(copy.getCaching(), false);
+  EXPECT_EQ(moved.getCaching(), true);
+  moved.setCaching(false);
+  EXPECT_EQ(moved.getCaching(), false);
+}
+TEST(MatrixTest, setCaching_LowRankUpdate) {
+  double ar[]{2, 5, 0, 4, 8, 0, 1, 5, 10};
+  double ar_u[]{1, 0, 2};
+  Matrix matrix(3, 3, 9, ar), u(3, 1, 3, ar_u);
+  matrix.setCaching(true);
+  Matrix inverse = matrix.InverseMatrix();
+  double det = matrix.Determinant();
+  matrix.LowRankUpdate(u, u, inverse, det);
+  EXPECT_EQ(matrix.Determinant(), det);
+  EXPECT_EQ(matrix.InverseMatrix() == inverse, true);
+}
+TEST(MatrixTest, setCaching_Threads) {
+  Matrix matrix(6, 6);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) matrix(i, j) = (i + 2 * j) % 5 + (i == j) * 9;
+  }
+  const double det = matrix.Determinant();
+  const Matrix inverse = matrix.InverseMatrix();
+  matrix.setCaching(true);
+  for (int round = 0; round < 20; round++) {
+    // Every round starts with a stale cache all the threads race to fill.
+    matrix(0, 0) = matrix(0, 0);
+    const Matrix& shared = matrix;
+    std::vector<std::thread> threads;
+    std::vector<int> matches(8);
+    for (int t = 0; t < 8; t++) {
+      threads.emplace_back([&shared, &matches, &det, &inverse, t] {
+        if (t % 2)
+          matches[t] = shared.InverseMatrix() == inverse;
+        else
+          matches[t] = shared.Determinant() == det;
+      });
+    }
+    for (std::thread& thread : threads) thread.join();
+    EXPECT_EQ(std::count(matches.begin(), matches.end(), 1), 8);
+  }
+}
+
+TEST(MatrixTest, getStride) {
+  Matrix matrix(3, 13), small(2, 3), aliased(2, 512), empty;
+  EXPECT_EQ(matrix.getStride(), 16);
+  EXPECT_EQ(small.getStride(), 4);
+  EXPECT_EQ(aliased.getStride(), 520);
+  EXPECT_EQ(empty.getStride(), 0);
+  EXPECT_EQ(empty.getData(), nullptr);
+  for (int i = 0; i < matrix.getRows(); i++) {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(matrix.getMatrix()[i]) %
+                  MEMORY_ALIGNMENT,
+              0u);
+  }
+  matrix(2, 5) = 4;
+  EXPECT_EQ(matrix.getData()[2 * matrix.getStride() + 5], 4);
+  EXPECT_EQ(matrix.getData() + matrix.getStride(), matrix.getMatrix()[1]);
+}
+
+TEST(MatrixTest, Solve) {
+  double ar[]{2, 5, 0, 4, 8, 0, 1, 5, 10};
+  double ar_b[]{12, 1, 20, 0, 21, 0};
+  double ar_v[]{12, 20, 21};
+  Matrix matrix(3, 3, 9, ar), b(3, 2, 6, ar_b);
+  Matrix x = matrix.Solve(b), x_mixed = matrix.Solve(b, Precision::Mixed);
+  EXPECT_EQ(matrix * x == b, true);
+  EXPECT_NEAR(x(0, 0), 1, 1e-12);
+  EXPECT_NEAR(x(1, 0), 2, 1e-12);
+  EXPECT_NEAR(x(2, 0), 1, 1e-12);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 2; j++) EXPECT_NEAR(x_mixed(i, j), x(i, j), 1e-13);
+  }
+  Vector v(3, 3, ar_v), v_x = matrix.Solve(v, Precision::Mixed);
+  EXPECT_NEAR(v_x[1], 2, 1e-13);
+}
+TEST(MatrixTest, Solve_Refinement) {
+  const int n = 120;
+  Matrix matrix(n, n), hilbert(8, 8);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++)
+      matrix(i, j) = (i == j) ? n : 1.0 / (1 + (i * 7 + j * 3) % 11);
+  }
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 8; j++) hilbert(i, j) = 1.0 / (i + j + 1);
+  }
+  Vector b(n), b_h(8);
+  for (int i = 0; i < n; i++) b[i] = i % 5 - 2.5;
+  for (int i = 0; i < 8; i++) b_h[i] = 1;
+  Vector x = matrix.Solve(b), x_mixed = matrix.Solve(b, Precision::Mixed);
+  for (int i = 0; i < n; i++) EXPECT_NEAR(x_mixed[i], x[i], 1e-14);
+  Vector h = hilbert.Solve(b_h), h_mixed = hilbert.Solve(b_h, Precision::Mixed);
+  for (int i = 0; i < 8; i++) EXPECT_NEAR(h_mixed[i] / h[i], 1, 1e-6);
+  Vector no_steps = matrix.Solve(b, Precision::Mixed, 0);
+  for (int i = 0; i < n; i++) EXPECT_NEAR(no_steps[i], x[i], 1e-14);
+}
+TEST(MatrixTest, InverseMatrix_Precision) {
+  double ar[]{1, 2, 0, 5, 0, 1, -5, 0.5, 0, 0, 0, 2, 1, 0, 0, 1};
+  Matrix matrix(4, 4, 16, ar);
+  Matrix inverse = matrix.InverseMatrix();
+  EXPECT_EQ(matrix.InverseMatrix(Precision::Double) == inverse, true);
+  EXPECT_EQ(matrix.InverseMatrix(Precision::Mixed) == inverse, true);
+  EXPECT_EQ(matrix.InverseMatrix(Precision::Mixed, 2) == inverse, true);
+}
+TEST(MatrixTest, Solve_Exception) {
+  double ar[]{1, 2, 2, 4};
+  Matrix singular(2, 2, 4, ar), rect(2, 3), b(3, 1), empty;
+  Vector v(2);
+  EXPECT_THROW(singular.Solve(v), NonInvertibleError);
+  EXPECT_THROW(singular.Solve(v, Precision::Mixed), NonInvertibleError);
+  EXPECT_THROW(singular.InverseMatrix(Precision::Double), NonInvertibleError);
+  EXPECT_THROW(rect.Solve(v), SquarenessError);
+  EXPECT_THROW(singular.Solve(b), DimentionAlignmentError);
+  EXPECT_THROW(singular.Solve(empty), MatrixSetError);
+  EXPECT_THROW(singular.Solve(v, Precision::Mixed, -1), InputError);
+}
+
+TEST(MatrixTest, Async_Operations) {
+  double ar[]{2, 5, 7, 6, 3, 4, 5, -2, -3};
+  double ones[]{1, 1, 1};
+  Matrix matrix(3, 3, 9, ar), b(3, 1, 3, ones);
+  std::future<Matrix> product = MatrixAsync::multiply(matrix, matrix);
+  std::future<Matrix> inverse = MatrixAsync::inverse(matrix);
+  std::future<double> determinant = MatrixAsync::determinant(matrix);
+  std::future<Matrix> solution = MatrixAsync::solve(matrix, b);
+  matrix *= 0;
+  EXPECT_EQ(product.get() == Matrix(3, 3, 9, ar) * Matrix(3, 3, 9, ar), true);
+  EXPECT_EQ(inverse.get() == Matrix(3, 3, 9, ar).InverseMatrix(), true);
+  EXPECT_NEAR(determinant.get(), -1, 1e-9);
+  EXPECT_EQ(Matrix(3, 3, 9, ar) * solution.get() == b, true);
+}
+TEST(MatrixTest, Async_Exception) {
+  Matrix rect(2, 3), empty;
+  std::future<Matrix> inverse = MatrixAsync::inverse(rect);
+  std::future<Matrix> product = MatrixAsync::multiply(rect, rect);
+  std::future<double> determinant = MatrixAsync::determinant(empty);
+  EXPECT_THROW(inverse.get(), SquarenessError);
+  EXPECT_THROW(product.get(), DimentionAlignmentError);
+  EXPECT_THROW(MatrixAsync::wait(determinant), MatrixSetError);
+}
+TEST(MatrixTest, Async_DeterminantLarge) {
+  // Far beyond the reach of a cofactor expansion (14! terms).
+  Matrix matrix(14, 14);
+  for (int i = 0; i < 14; i++) {
+    for (int j = i; j < 14; j++) matrix(13 - i, j) = i == j ? 2 : j - i;
+  }
+  std::future<double> determinant = MatrixAsync::determinant(matrix);
+  // Reversing the 14 rows takes 7 swaps.
+  EXPECT_NEAR(determinant.get(), -16384, 1e-6);
+  double det = 0;
+  EXPECT_EQ(matrix.TryDeterminant(det), MatrixStatus::Ok);
+  EXPECT_NEAR(det, -16384, 1e-6);
+}
+TEST(MatrixTest, Scheduler_NestedTasks) {
+  MatrixScheduler scheduler(1);
+  std::function<long(int)> fibonacci = [&](int n) -> long {
+    if (n < 2) return n;
+    std::future<long> left = scheduler.submit([&, n]() {
+      return fibonacci(n - 1);
+    });
+    const long right = fibonacci(n - 2);
+    return scheduler.wait(left) + right;
+  };
+  std::future<long> result = scheduler.submit([&]() { return fibonacci(15); });
+  EXPECT_EQ(scheduler.wait(result), 610);
+  EXPECT_EQ(scheduler.getWorkers(), 1);
+}
+TEST(MatrixTest, Scheduler_NestedParallelKernels) {
+  const int n = 96;
+  Matrix matrix(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) matrix(i, j) = (i * 7 + j * 3) % 11 - 5;
+  }
+  Matrix expected = matrix * matrix;
+  std::vector<std::future<Matrix>> products;
+  for (int t = 0; t < 8; t++) {
+    products.push_back(MatrixAsync::submit([&matrix]() {
+      std::future<Matrix> inner = MatrixAsync::multiply(matrix, matrix);
+      return MatrixAsync::wait(inner);
+    }));
+  }
+  for (std::future<Matrix>& product : products)
+    EXPECT_EQ(product.get() == expected, true);
+}
+
+TEST(MatrixTest, MultiplyChain) {
+  Matrix a(30, 5), b(5, 40), c(40, 3), d(3, 7);
+  for (Matrix* m : {&a, &b, &c, &d}) {
+    for (int i = 0; i < m->getRows(); i++) {
+      for (int j = 0; j < m->getCols(); j++)
+        (*m)(i, j) = (i * 3 + j * 5) % 7 - 3;
+    }
+  }
+  Matrix expected = a * b * c * d;
+  EXPECT_EQ(Matrix::MultiplyChain({a, b, c, d}) == expected, true);
+  EXPECT_EQ(Matrix::MultiplyChain({a, b}) == a * b, true);
+  EXPECT_EQ(Matrix::MultiplyChain({c}) == c, true);
+  Matrix d_t = d.Transpose(), c_t = c.Transpose();
+  Matrix chain = Matrix::MultiplyChain({b, c, d, d_t, c_t});
+  EXPECT_EQ(chain == b * c * d * d_t * c_t, true);
+}
+TEST(MatrixTest, MultiplyChain_Exception) {
+  Matrix a(2, 3), b(4, 2), empty;
+  EXPECT_THROW(Matrix::MultiplyChain({}), InputError);
+  EXPECT_THROW(Matrix::MultiplyChain({a, b}), DimentionAlignmentError);
+  EXPECT_THROW(Matrix::MultiplyChain({a, empty}), MatrixSetError);
+}
+
+TEST(MatrixTest, Pow) {
+  double ar[]{1, 1, 1, 0};
+  Matrix fibonacci(2, 2, 4, ar);
+  Matrix power = fibonacci.Pow(40);
+  EXPECT_EQ(power(0, 1), 102334155);
+  EXPECT_EQ(power(0, 0), 165580141);
+  Matrix repeated = fibonacci;
+  for (int i = 1; i < 13; i++) repeated *= fibonacci;
+  EXPECT_EQ(fibonacci.Pow(13) == repeated, true);
+  EXPECT_EQ(fibonacci.Pow(1) == fibonacci, true);
+  double id[]{1, 0, 0, 1};
+  EXPECT_EQ(fibonacci.Pow(0) == Matrix(2, 2, 4, id), true);
+}
+TEST(MatrixTest, Pow_Negative) {
+  double ar[]{2, 5, 7, 6, 3, 4, 5, -2, -3};
+  Matrix matrix(3, 3, 9, ar);
+  Matrix inverse = matrix.InverseMatrix();
+  EXPECT_EQ(matrix.Pow(-1) == inverse, true);
+  EXPECT_EQ(matrix.Pow(-3) == inverse * inverse * inverse, true);
+  EXPECT_EQ(matrix.Pow(-3) * matrix.Pow(3) == matrix.Pow(0), true);
+}
+TEST(MatrixTest, Pow_Exception) {
+  double ar[]{1, 2, 2, 4};
+  Matrix singular(2, 2, 4, ar), rect(2, 3), empty;
+  EXPECT_THROW(singular.Pow(-2), NonInvertibleError);
+  EXPECT_THROW(rect.Pow(2), SquarenessError);
+  EXPECT_THROW(empty.Pow(2), MatrixSetError);
+  Matrix big(2, 2);
+  big(0, 0) = 1e200;
+  EXPECT_THROW(big.Pow(2), DataError);
+}
+
+TEST(MatrixTest, DiagonalMatrix) {
+  double ar[]{2, -4, 0.5};
+  DiagonalMatrix diagonal(3, 3, ar);
+  Matrix full = diagonal;
+  double b_ar[]{1, 2, 3, 4, 5, 6};
+  Matrix b(3, 2, 6, b_ar);
+  EXPECT_EQ(diagonal * b == full * b, true);
+  EXPECT_EQ(full * diagonal.Solve(b) == b, true);
+  EXPECT_NEAR(diagonal.Determinant(), -4, 1e-12);
+  EXPECT_EQ(Matrix(diagonal.InverseMatrix()) == full.InverseMatrix(), true);
+  EXPECT_EQ(DiagonalMatrix(full).getElement(1, 1), -4);
+  EXPECT_EQ(diagonal.getElement(0, 1), 0);
+  EXPECT_EQ(diagonal.getPackedSize(), 3);
+  EXPECT_THROW(diagonal.setElement(0, 1, 1), OutOfRangeError);
+  EXPECT_THROW(DiagonalMatrix{b}, SquarenessError);
+  EXPECT_THROW(DiagonalMatrix(3).Solve(b), NonInvertibleError);
+}
+TEST(MatrixTest, TriangularMatrix) {
+  double ar[]{2, 0, 0, 1, 3, 0, -1, 4, 5};
+  Matrix full(3, 3, 9, ar);
+  TriangularMatrix lower(full, Triangle::Lower);
+  Matrix full_t = full.Transpose();
+  TriangularMatrix upper(full_t, Triangle::Upper);
+  EXPECT_EQ(lower.getPackedSize(), 6);
+  EXPECT_EQ(Matrix(lower) == full, true);
+  EXPECT_EQ(Matrix(upper) == full_t, true);
+  EXPECT_EQ(upper.getElement(0, 2), -1);
+  EXPECT_EQ(upper.getElement(2, 0), 0);
+  double b_ar[]{1, 2, 3, 4, 5, 6};
+  Matrix b(3, 2, 6, b_ar);
+  EXPECT_EQ(lower * b == full * b, true);
+  EXPECT_EQ(upper * b == full_t * b, true);
+  EXPECT_EQ(full * lower.Solve(b) == b, true);
+  EXPECT_EQ(full_t * upper.Solve(b) == b, true);
+  Vector x(3, 3, b_ar);
+  EXPECT_EQ(lower * x == full * x, true);
+  EXPECT_EQ((lower * x).getElement(2), 22);
+  EXPECT_NEAR(lower.Determinant(), 30, 1e-12);
+  EXPECT_EQ(Matrix(lower.InverseMatrix()) == full.InverseMatrix(), true);
+  EXPECT_EQ(Matrix(upper.InverseMatrix()) == full_t.InverseMatrix(), true);
+  EXPECT_THROW(TriangularMatrix(full_t, Triangle::Lower), InputError);
+  EXPECT_THROW(lower.setElement(0, 2, 1), OutOfRangeError);
+}
+TEST(MatrixTest, SymmetricMatrix) {
+  double ar[]{4, 2, -2, 2, 10, 4, -2, 4, 9};
+  Matrix full(3, 3, 9, ar);
+  SymmetricMatrix symmetric(full);
+  EXPECT_EQ(symmetric.getPackedSize(), 6);
+  EXPECT_EQ(Matrix(symmetric) == full, true);
+  double b_ar[]{1, 2, 3, 4, 5, 6};
+  Matrix b(3, 2, 6, b_ar);
+  Vector v(3, 3, b_ar);
+  EXPECT_EQ(symmetric * b == full * b, true);
+  EXPECT_EQ(symmetric * v == full * v, true);
+  EXPECT_EQ(full * symmetric.Solve(b) == b, true);
+  EXPECT_EQ(full * symmetric.Solve(v) == v, true);
+  EXPECT_NEAR(symmetric.Determinant(), full.Determinant(), 1e-9);
+  EXPECT_EQ(Matrix(symmetric.InverseMatrix()) == full.InverseMatrix(), true);
+  symmetric.setElement(0, 2, 7);
+  EXPECT_EQ(symmetric.getElement(2, 0), 7);
+  double bad[]{1, 2, 3, 4};
+  EXPECT_THROW(SymmetricMatrix(Matrix(2, 2, 4, bad)), InputError);
+}
+TEST(MatrixTest, SymmetricMatrix_Indefinite) {
+  double ar[]{0, 1, 2, 1, 0, 3, 2, 3, 0};
+  Matrix full(3, 3, 9, ar);
+  SymmetricMatrix symmetric(full);
+  double b_ar[]{1, -2, 5};
+  Vector b(3, 3, b_ar);
+  EXPECT_EQ(full * symmetric.Solve(b) == b, true);
+  EXPECT_NEAR(symmetric.Determinant(), 12, 1e-12);
+  EXPECT_EQ(Matrix(symmetric.InverseMatrix()) == full.InverseMatrix(), true);
+}
+TEST(MatrixTest, BandedMatrix) {
+  const int n = 7;
+  BandedMatrix banded(n, 2, 1);
+  for (int i = 0; i < n; i++) {
+    for (int j = std::max(0, i - 2); j <= std::min(n - 1, i + 1); j++)
+      banded.setElement(i, j, (i * 5 + j * 3) % 7 - 3 + (i == j ? 0.5 : 0));
+  }
+  Matrix full = banded;
+  EXPECT_EQ(banded.getPackedSize(), 4L * n);
+  EXPECT_EQ(banded.getElement(0, 5), 0);
+  EXPECT_THROW(banded.setElement(0, 5, 1), OutOfRangeError);
+  EXPECT_EQ(Matrix(BandedMatrix(full, 2, 1)) == full, true);
+  EXPECT_THROW(BandedMatrix(full, 1, 1), InputError);
+  Matrix b(n, 2);
+  for (int i = 0; i < n; i++) b(i, 0) = b(i, 1) = i - 4;
+  Vector v(n);
+  for (int i = 0; i < n; i++) v[i] = i % 3 - 1;
+  EXPECT_EQ(banded * b == full * b, true);
+  EXPECT_EQ(banded * v == full * v, true);
+  EXPECT_EQ(full * banded.Solve(b) == b, true);
+  EXPECT_EQ(full * banded.Solve(v) == v, true);
+  EXPECT_NEAR(banded.Determinant() / full.Determinant(), 1, 1e-9);
+  EXPECT_EQ(banded.InverseMatrix() == full.InverseMatrix(Precision::Double),
+            true);
+  EXPECT_THROW(BandedMatrix(n, 2, 1).Solve(v), NonInvertibleError);
+  EXPECT_THROW(BandedMatrix(n, -1, 1), InputError);
+  // Rejected before the band of 3 * 10^10 elements is allocated.
+  EXPECT_THROW(BandedMatrix(100000, 0, 300000), InputError);
+  EXPECT_THROW(BandedMatrix(0, 0, 0), DimentionError);
+}
+
+TEST(MatrixTest, TiledMatrix_Operations) {
+  Matrix a(37, 23), b(23, 29), c(37, 23);
+  for (int i = 0; i < 37; i++) {
+    for (int j = 0; j < 23; j++) {
+      a(i, j) = (i * 7 + j * 3) % 11 - 5;
+      c(i, j) = (i + 2 * j) % 5;
+    }
+  }
+  for (int i = 0; i < 23; i++) {
+    for (int j = 0; j < 29; j++) b(i, j) = (i * 5 + j) % 9 - 4;
+  }
+  {
+    TiledMatrix tiled_a("tiled_a.mtx", a, 8, 4);
+    TiledMatrix tiled_b("tiled_b.mtx", b, 8, 4);
+    TiledMatrix tiled_c("tiled_c.mtx", c, 8, 4);
+    // Tiles that are written in full are never read from the file.
+    EXPECT_EQ(tiled_a.getTileReads(), 0);
+    EXPECT_EQ(Matrix(tiled_a) == a, true);
+    EXPECT_EQ(tiled_a.getCachedTiles() <= 4, true);
+    TiledMatrix product = tiled_a.Multiply(tiled_b, "tiled_r.mtx");
+    EXPECT_EQ(product.getTileReads(), 0);
+    EXPECT_EQ(Matrix(product) == a * b, true);
+    TiledMatrix sum = tiled_a.Add(tiled_c, "tiled_s.mtx");
+    EXPECT_EQ(sum.getTileReads(), 0);
+    EXPECT_EQ(Matrix(sum) == a + c, true);
+    Matrix a_t = a.Transpose();
+    TiledMatrix transposed = tiled_a.Transpose("tiled_t.mtx");
+    EXPECT_EQ(transposed.getTileReads(), 0);
+    EXPECT_EQ(Matrix(transposed) == a_t, true);
+    EXPECT_EQ(tiled_a.getTileWrites() > 0, true);
+    tiled_a.setElement(36, 22, 0.5);
+    EXPECT_EQ(tiled_a.getElement(36, 22), 0.5);
+  }
+  TiledMatrix reopened("tiled_a.mtx", 2);
+  EXPECT_EQ(reopened.getRows(), 37);
+  EXPECT_EQ(reopened.getTileSize(), 8);
+  EXPECT_EQ(reopened.getElement(36, 22), 0.5);
+  EXPECT_EQ(reopened.getElement(3, 4), a(3, 4));
+  for (const char* path : {"tiled_a.mtx", "tiled_b.mtx", "tiled_c.mtx",
+                           "tiled_r.mtx", "tiled_s.mtx", "tiled_t.mtx"})
+    std::remove(path);
+}
+TEST(MatrixTest, TiledMatrix_LU) {
+  const int n = 30;
+  Matrix a(n, n);
+  Vector b(n);
+  for (int i = 0; i < n; i++) {
+    b[i] = i % 4 - 1.5;
+    for (int j = 0; j < n; j++)
+      a(i, j) = (i * 13 + j * 7) % 17 - 8 + (i == j ? 0.25 : 0);
+  }
+  {
+    TiledMatrix tiled("tiled_a.mtx", a, 7, 6);
+    std::vector<int> pivots;
+    TiledMatrix lu = tiled.DecomposeLU("tiled_lu.mtx", pivots);
+    Vector x = lu.SolveLU(pivots, b);
+    EXPECT_EQ(a * x == b, true);
+    EXPECT_EQ(x == a.Solve(b), true);
+  }
+  {
+    Matrix singular(10, 10);
+    TiledMatrix tiled("tiled_a.mtx", singular, 4, 4);
+    std::vector<int> pivots;
+    EXPECT_THROW(tiled.DecomposeLU("tiled_lu.mtx", pivots),
+                 NonInvertibleError);
+  }
+  std::remove("tiled_a.mtx");
+  std::remove("tiled_lu.mtx");
+}
+TEST(MatrixTest, TiledMatrix_Exception) {
+  Matrix a(4, 3), b(4, 4);
+  TiledMatrix tiled_a("tiled_a.mtx", a, 2), tiled_b("tiled_b.mtx", b, 2);
+  TiledMatrix other_tiles("tiled_c.mtx", b, 3);
+  EXPECT_THROW(tiled_a.Multiply(tiled_b, "tiled_r.mtx"),
+               DimentionAlignmentError);
+  EXPECT_THROW(tiled_a.Add(tiled_b, "tiled_r.mtx"), DimentionEqualityError);
+  EXPECT_THROW(tiled_b.Add(other_tiles, "tiled_r.mtx"), InputError);
+  EXPECT_THROW(tiled_a.getElement(4, 0), OutOfRangeError);
+  std::vector<int> pivots;
+  EXPECT_THROW(tiled_a.DecomposeLU("tiled_r.mtx", pivots), SquarenessError);
+  EXPECT_THROW(TiledMatrix("tiled_missing.mtx"), InputError);
+  EXPECT_THROW(TiledMatrix("tiled_r.mtx", Matrix()), MatrixSetError);
+  EXPECT_THROW(TiledMatrix("tiled_r.mtx", 0, 3), DimentionError);
+  for (const char* path : {"tiled_a.mtx", "tiled_b.mtx", "tiled_c.mtx",
+                           "tiled_r.mtx", "tiled_s.mtx", "tiled_t.mtx"})
+    std::remove(path);
+}
+
+TEST(MatrixTest, Numa_MemoryPolicy) {
+  const MemoryPolicy initial = MatrixNuma::getMemoryPolicy();
+  EXPECT_GE(MatrixNuma::nodeCount(), 1);
+  for (MemoryPolicy policy : {MemoryPolicy::FirstTouch,
+                              MemoryPolicy::Interleave, MemoryPolicy::Local}) {
+    MatrixNuma::setMemoryPolicy(policy);
+    EXPECT_EQ(MatrixNuma::getMemoryPolicy() == policy, true);
+    Matrix big(1024, 300);
+    double sum = 0;
+    for (int i = 0; i < big.getRows(); i += 7) {
+      for (int j = 0; j < big.getCols(); j += 3) sum += big(i, j);
+    }
+    EXPECT_EQ(sum, 0);
+    big(1023, 299) = 2;
+    Matrix product = big * big.Transpose();
+    EXPECT_EQ(product(1023, 1023), 4);
+  }
+  // First touch is only kept by pinned workers.
+  EXPECT_EQ(MatrixScheduler::instance().isPinned(), true);
+  // Blocks are freed the way they were allocated, whatever the policy is.
+  MatrixNuma::setMemoryPolicy(MemoryPolicy::Interleave);
+  Vector mapped(200000);
+  MatrixNuma::setMemoryPolicy(MemoryPolicy::Local);
+  Vector heap(200000);
+  mapped[199999] = 1;
+  EXPECT_EQ(mapped.Dot(heap), 0);
+  MatrixNuma::setMemoryPolicy(initial);
+}
+TEST(MatrixTest, Numa_PinnedScheduler) {
+  MatrixScheduler scheduler(2, true);
+  EXPECT_EQ(scheduler.isPinned(), true);
+  std::future<int> result = scheduler.submit([]() { return 6 * 7; });
+  EXPECT_EQ(scheduler.wait(result), 42);
+  EXPECT_EQ(MatrixScheduler(1).isPinned(), false);
+  MatrixScheduler later(3);
+  later.pinWorkers();
+  EXPECT_EQ(later.isPinned(), true);
+  std::vector<std::thread::id> ids(6);
+  std::atomic<int> remaining(6);
+  for (int k = 0; k < 6; k++) {
+    later.pushBound(k, [&ids, &remaining, k]() {
+      ids[k] = std::this_thread::get_id();
+      remaining--;
+    });
+  }
+  while (remaining > 0) std::this_thread::yield();
+  for (int k = 0; k < 3; k++) {
+    EXPECT_EQ(ids[k] == ids[k + 3], true);
+    EXPECT_EQ(ids[k] != ids[(k + 1) % 3], true);
+  }
+}
+
+TEST(MatrixTest, Tuning_SaveLoad) {
+  TuningConfig tuned;
+  tuned.transpose_block = 8;
+  tuned.multiply_block = 3;
+  tuned.parallel_grain = 1L << 10;
+  tuned.blas_order = 96;
+  EXPECT_EQ(MatrixTuning::save("tuning.conf", tuned), true);
+  TuningConfig loaded;
+  EXPECT_EQ(MatrixTuning::load("tuning.conf", loaded), true);
+  EXPECT_EQ(loaded.transpose_block, 8);
+  EXPECT_EQ(loaded.multiply_block, 3);
+  EXPECT_EQ(loaded.parallel_grain, 1L << 10);
+  EXPECT_EQ(loaded.blas_order, 96);
+  {
+    std::ofstream file("tuning.conf");
+    file << "host = another cpu\ntranspose_block = 4\n";
+  }
+  TuningConfig other;
+  EXPECT_EQ(MatrixTuning::load("tuning.conf", other), false);
+  EXPECT_EQ(other.transpose_block, TRANSPOSE_BLOCK);
+  {
+    std::ofstream file("tuning.conf");
+    file << "# comment\nhost = " << MatrixTuning::hostName()
+         << "\ntranspose_block = -4\nmultiply_block = x\nunknown = 1\n";
+  }
+  TuningConfig invalid;
+  EXPECT_EQ(MatrixTuning::load("tuning.conf", invalid), true);
+  EXPECT_EQ(invalid.transpose_block, TRANSPOSE_BLOCK);
+  EXPECT_EQ(invalid.multiply_block, MULTIPLY_BLOCK);
+  std::remove("tuning.conf");
+  EXPECT_EQ(MatrixTuning::load("tuning.conf", invalid), false);
+}
+TEST(MatrixTest, Tuning_KernelsFollowConfig) {
+  const TuningConfig initial = MatrixTuning::get();
+  Matrix a(37, 45), b(45, 29);
+  for (int i = 0; i < 45; i++) {
+    for (int j = 0; j < 37; j++) a(j, i) = (i * 3 + j * 5) % 11 - 5;
+    for (int j = 0; j < 29; j++) b(i, j) = (i * 7 + j) % 13 - 6;
+  }
+  const Matrix product = a * b, transposed = a.Transpose();
+  TuningConfig tuned;
+  tuned.transpose_block = 5;
+  tuned.multiply_block = 4;
+  tuned.parallel_grain = 1;
+  MatrixTuning::set(tuned);
+  EXPECT_EQ(MatrixTuning::get().multiply_block, 4);
+  EXPECT_EQ(a * b == product, true);
+  EXPECT_EQ(Matrix(a.Transpose()) == transposed, true);
+  tuned.transpose_block = 0;
+  MatrixTuning::set(tuned);
+  EXPECT_EQ(MatrixTuning::get().transpose_block, TRANSPOSE_BLOCK);
+  MatrixTuning::set(initial);
+}
+
+TEST(MatrixTest, UncheckedAccess) {
+  Matrix matrix(3, 5);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++) matrix[i][j] = i * 5 + j;
+  }
+  EXPECT_EQ(matrix(2, 3), 13);
+  EXPECT_EQ(matrix.data()[matrix.getStride() + 4], 9);
+  const Matrix& view = matrix;
+  EXPECT_EQ(view[1][2], 7);
+  EXPECT_EQ(view.data(), view.getData());
+  matrix.setCaching(true);
+  matrix.setDimentions(3, 3);
+  const double det = matrix.Determinant();
+  EXPECT_EQ(det, 0);
+  matrix[0][0] = 100;
+  EXPECT_EQ(matrix.Determinant() == det, false);
+}
+TEST(MatrixTest, Iterators) {
+  Matrix matrix(3, 5);
+  std::iota(matrix.begin(), matrix.end(), 0);
+  EXPECT_EQ(matrix.end() - matrix.begin(), 15);
+  EXPECT_EQ(matrix(1, 0), 5);
+  EXPECT_EQ(matrix(2, 4), 14);
+  const Matrix& view = matrix;
+  EXPECT_EQ(std::accumulate(view.begin(), view.end(), 0.0), 105);
+  Matrix::const_iterator it = view.begin() + 7;
+  EXPECT_EQ(*it, 7);
+  EXPECT_EQ(it[-3], 4);
+  EXPECT_EQ(*(it - 6), 1);
+  EXPECT_EQ(*(9 + view.begin()), 9);
+  EXPECT_EQ(view.end() - it, 8);
+  EXPECT_EQ(it < view.end() && view.begin() <= it, true);
+  EXPECT_EQ(*--it, 6);
+  EXPECT_EQ(*std::max_element(view.begin(), view.end()), 14);
+  std::sort(matrix.begin(), matrix.end(), std::greater<double>());
+  EXPECT_EQ(matrix(0, 0), 14);
+  EXPECT_EQ(matrix(2, 4), 0);
+  std::reverse(matrix.begin(), matrix.end());
+
+  EXPECT_EQ(matrix.row(1).size(), 5);
+  EXPECT_EQ(std::accumulate(view.row(1).begin(), view.row(1).end(), 0.0), 35);
+  for (double& value : matrix.row(2)) value = -value;
+  EXPECT_EQ(matrix(2, 1), -11);
+  Matrix::ConstColumn column = view.column(3);
+  EXPECT_EQ(column.size(), 3);
+  EXPECT_EQ(column[2], -13);
+  EXPECT_EQ(std::accumulate(column.begin(), column.end(), 0.0), 3 + 8 - 13);
+  Matrix::Column mutable_column = matrix.column(0);
+  std::fill(mutable_column.begin(), mutable_column.end(), 1);
+  EXPECT_EQ(matrix(1, 0), 1);
+  EXPECT_EQ(matrix(1, 1), 6);
+  std::sort(mutable_column.begin(), mutable_column.end());
+  EXPECT_EQ(*std::min_element(view.column(1).begin(), view.column(1).end()),
+            -11);
+  Matrix empty;
+  EXPECT_EQ(empty.begin() == empty.end(), true);
+  Vector vector(4);
+  std::iota(vector.begin(), vector.end(), 1);
+  EXPECT_EQ(std::accumulate(vector.begin(), vector.end(), 0.0), 10);
+}
+
+TEST(MatrixTest, MapZip) {
+  double ar[]{1, -2, 3, 4, 0.5, -6};
+  Matrix a(2, 3, 6, ar), b(2, 3, 6, ar);
+  Matrix squared = a.Map([](double x) { return x * x; });
+  EXPECT_EQ(squared(0, 1), 4);
+  EXPECT_EQ(squared(1, 2), 36);
+  EXPECT_EQ(Matrix::Zip(a, squared, [](double x, double y) { return x + y; })(
+                1, 0),
+            20);
+  EXPECT_EQ(a.HadamardProduct(b) == squared, true);
+  EXPECT_EQ(squared.HadamardDivision(a) == a, true);
+  Matrix clamped = a.Clamp(-1, 2);
+  EXPECT_EQ(clamped(0, 1), -1);
+  EXPECT_EQ(clamped(0, 2), 2);
+  EXPECT_EQ(clamped(1, 1), 0.5);
+  EXPECT_NEAR(a.Exp()(1, 1), std::exp(0.5), 1e-15);
+  EXPECT_NEAR(squared.Log()(1, 2), std::log(36.0), 1e-15);
+  EXPECT_NEAR(a.Tanh()(0, 1), std::tanh(-2.0), 1e-15);
+  const unsigned long version = b.getVersion();
+  b.MapInPlace([](double x) { return 2 * x; });
+  EXPECT_EQ(b(1, 2), -12);
+  EXPECT_EQ(b.getVersion() > version, true);
+  b.ZipInPlace(a, [](double x, double y) { return x - y; });
+  EXPECT_EQ(b == a, true);
+  b.ZipInPlace(b, [](double x, double y) { return x * y; });
+  EXPECT_EQ(b == squared, true);
+
+  EXPECT_THROW(a.Log(), DataError);
+  EXPECT_THROW(a.HadamardDivision(Matrix(2, 3)), DataError);
+  EXPECT_THROW(a.Clamp(1, -1), InputError);
+  EXPECT_THROW(a.HadamardProduct(Matrix(3, 2)), DimentionEqualityError);
+  EXPECT_THROW(b.ZipInPlace(Matrix(1, 1), std::plus<double>()),
+               DimentionEqualityError);
+  EXPECT_THROW(Matrix().Exp(), MatrixSetError);
+  EXPECT_THROW(b.MapInPlace([](double) { return NAN; }), DataError);
+}
+TEST(MatrixTest, MapZip_Parallel) {
+  const int size = 700;
+  Matrix a(size, size), b(size, size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      a[i][j] = (i + j) % 9 - 4;
+      b[i][j] = (i * j) % 5 + 1;
+    }
+  }
+  Matrix product = a.HadamardProduct(b);
+  Matrix quotient = product.HadamardDivision(b);
+  EXPECT_EQ(quotient == a, true);
+  EXPECT_EQ(product(size - 1, size - 2), a(size - 1, size - 2) *
+                                             b(size - 1, size - 2));
+  a.MapInPlace([](double x) { return x + 4; });
+  EXPECT_EQ(*std::min_element(a.begin(), a.end()), 0);
+  EXPECT_EQ(*std::max_element(a.begin(), a.end()), 8);
+}
+
+TEST(MatrixTest, Reductions) {
+  double ar[]{1, -7, 3, 2, 4, 0.5, -6, 5, 8, 1, 2, -3};
+  Matrix a(3, 4, 12, ar);
+  EXPECT_DOUBLE_EQ(a.Sum(), 10.5);
+  EXPECT_DOUBLE_EQ(a.Mean(), 10.5 / 12);
+  EXPECT_EQ(a.Min(), -7);
+  EXPECT_EQ(a.Max(), 8);
+  EXPECT_DOUBLE_EQ(a.Reduce(Reduction::NormOne), 42.5);
+  EXPECT_EQ(a.Reduce(Reduction::NormInf), 8);
+  EXPECT_DOUBLE_EQ(a.Norm(), std::sqrt(218.25));
+  EXPECT_DOUBLE_EQ(a.Norm(MatrixNorm::One), 13);
+  EXPECT_DOUBLE_EQ(a.Norm(MatrixNorm::Infinity), 15.5);
+  Vector rows = a.ReduceRows(Reduction::Sum);
+  EXPECT_EQ(rows.getSize(), 3);
+  EXPECT_DOUBLE_EQ(rows[1], 3.5);
+  EXPECT_DOUBLE_EQ(a.ReduceRows(Reduction::Mean)[2], 2);
+  EXPECT_DOUBLE_EQ(a.ReduceRows(Reduction::NormTwo)[0], std::sqrt(63.0));
+  Vector cols = a.ReduceCols(Reduction::Max);
+  EXPECT_EQ(cols.getSize(), 4);
+  EXPECT_EQ(cols[0], 8);
+  EXPECT_EQ(cols[3], 5);
+  EXPECT_EQ(a.ReduceCols(Reduction::Min)[3], -3);
+  EXPECT_DOUBLE_EQ(a.ReduceCols(Reduction::NormOne)[2], 11);
+  int row = -1, col = -1;
+  a.ArgMax(row, col);
+  EXPECT_EQ(row, 2);
+  EXPECT_EQ(col, 0);
+  EXPECT_EQ(a.ArgMaxRows(), std::vector<int>({2, 3, 0}));
+  EXPECT_EQ(a.ArgMaxCols(), std::vector<int>({2, 2, 0, 1}));
+  EXPECT_DOUBLE_EQ(a.Dot(a), 218.25);
+  Matrix square(3, 3, 9, ar);
+  EXPECT_EQ(square.Trace(), 1 + 4 + 8);
+  EXPECT_THROW(a.Trace(), SquarenessError);
+  EXPECT_THROW(a.Dot(square), DimentionEqualityError);
+  EXPECT_THROW(Matrix().Sum(), MatrixSetError);
+  EXPECT_THROW(Matrix().ReduceCols(Reduction::Sum), MatrixSetError);
+  double big[]{1e308, 1e308};
+  EXPECT_THROW(Matrix(1, 2, 2, big).Sum(), DataError);
+}
+TEST(MatrixTest, Reductions_Parallel) {
+  const int rows = 900, cols = 500;
+  Matrix a(rows, cols);
+  long sum = 0;
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      a[i][j] = (i * 3 + j * 7) % 11 - 5;
+      sum += (i * 3 + j * 7) % 11 - 5;
+    }
+  }
+  a[456][321] = 100;
+  sum += 100 - ((456 * 3 + 321 * 7) % 11 - 5);
+  EXPECT_EQ(a.Sum(), sum);
+  Vector col_sums = a.ReduceCols(Reduction::Sum);
+  EXPECT_EQ(std::accumulate(col_sums.begin(), col_sums.end(), 0.0), sum);
+  Vector row_sums = a.ReduceRows(Reduction::Sum);
+  EXPECT_EQ(std::accumulate(row_sums.begin(), row_sums.end(), 0.0), sum);
+  int row = 0, col = 0;
+  a.ArgMax(row, col);
+  EXPECT_EQ(row, 456);
+  EXPECT_EQ(col, 321);
+  EXPECT_EQ(a.ArgMaxCols()[321], 456);
+  EXPECT_EQ(a.ArgMaxRows()[456], 321);
+  EXPECT_EQ(a.Max(), 100);
+  EXPECT_EQ(a.Min(), -5);
+}
+
+TEST(MatrixTest, DeterministicMode) {
+  const TuningConfig initial = MatrixTuning::get();
+  const bool deterministic = MatrixParallel::isDeterministic();
+  MatrixParallel::setDeterministic(true);
+  const int size = 20000, order = 120;
+  Vector x(size), y(size);
+  for (int i = 0; i < size; i++) {
+    x[i] = std::sin(i) * 1e3;
+    y[i] = std::cos(i * 0.7);
+  }
+  Matrix a(order, order), b(order, 3);
+  for (int i = 0; i < order; i++) {
+    for (int j = 0; j < order; j++) a[i][j] = std::sin(i * order + j);
+    a[i][i] += order;
+    for (int j = 0; j < 3; j++) b[i][j] = std::cos(i + j);
+  }
+  std::vector<double> blocks;
+  for (int first = 0; first < size; first += REDUCTION_BLOCK) {
+    blocks.push_back(MatrixService::dotProduct(
+        x.getData() + first, y.getData() + first,
+        std::min(REDUCTION_BLOCK, size - first)));
+  }
+  const double expected = MatrixParallel::pairwiseSum(
+      blocks.data(), static_cast<int>(blocks.size()));
+  std::vector<Matrix> products, solutions;
+  std::vector<double> sums;
+  TuningConfig tuned = initial;
+  // The grain changes how many threads share every loop.
+  for (long grain : {1L, PARALLEL_GRAIN, 1L << 40}) {
+    tuned.parallel_grain = grain;
+    MatrixTuning::set(tuned);
+    EXPECT_EQ(x.Dot(y), expected);
+    sums.push_back(a.Sum());
+    products.push_back(a * a);
+    solutions.push_back(a.Solve(b));
+  }
+  for (size_t k = 1; k < products.size(); k++) {
+    EXPECT_EQ(sums[k], sums[0]);
+    EXPECT_EQ(std::equal(products[k].begin(), products[k].end(),
+                         products[0].begin()),
+              true);
+    EXPECT_EQ(std::equal(solutions[k].begin(), solutions[k].end(),
+                         solutions[0].begin()),
+              true);
+  }
+  MatrixParallel::setDeterministic(false);
+  EXPECT_EQ(MatrixParallel::isDeterministic(), false);
+  EXPECT_NEAR(x.Dot(y), expected, 1e-9 * std::fabs(expected) + 1e-9);
+  MatrixParallel::setDeterministic(deterministic);
+  MatrixTuning::set(initial);
+}
+
+TEST(MatrixTest, RankRREFNullSpace) {
+  double ar[]{1, 2, 3, 4, 2, 4, 6, 8, 1, 0, 1, 0};
+  Matrix a(3, 4, 12, ar);
+  EXPECT_EQ(a.Rank(), 2);
+  EXPECT_EQ(a.Transpose().operator Matrix().Rank(), 2);
+  Matrix rref = a.RREF();
+  double expected[]{1, 0, 1, 0, 0, 1, 1, 2, 0, 0, 0, 0};
+  EXPECT_EQ(rref == Matrix(3, 4, 12, expected), true);
+  Matrix null = a.NullSpace();
+  EXPECT_EQ(null.getRows(), 4);
+  EXPECT_EQ(null.getCols(), 2);
+  Matrix zero = a * null;
+  EXPECT_NEAR(zero.Reduce(Reduction::NormInf), 0, 1e-12);
+  EXPECT_EQ(null.Rank(), 2);
+
+  Matrix identity(5, 5);
+  for (int i = 0; i < 5; i++) identity[i][i] = 1;
+  EXPECT_EQ(identity.Rank(), 5);
+  EXPECT_EQ(identity.RREF() == identity, true);
+  EXPECT_EQ(identity.NullSpace().getRows(), 0);
+
+  // A rank one perturbation below the tolerance is ignored.
+  double near[]{1, 1, 1, 1 + 1e-10};
+  Matrix almost(2, 2, 4, near);
+  EXPECT_EQ(almost.Rank(), 2);
+  EXPECT_EQ(almost.Rank(1e-8), 1);
+  EXPECT_EQ(almost.NullSpace(1e-8).getCols(), 1);
+  EXPECT_EQ(Matrix(3, 2).Rank(), 0);
+  EXPECT_THROW(Matrix().Rank(), MatrixSetError);
+  EXPECT_THROW(a.Rank(NAN), DataError);
+}
+TEST(MatrixTest, Rank_Large) {
+  const int size = 200;
+  Matrix a(size, size);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) a[i][j] = (i * 37 + j * 91) % 101 / 101.0;
+    a[i][i] += size;
+  }
+  EXPECT_EQ(a.Rank(), size);
+  // Make the last 10 rows combinations of the first two.
+  for (int i = size - 10; i < size; i++) {
+    for (int j = 0; j < size; j++) a[i][j] = a[0][j] * (i % 3) - a[1][j];
+  }
+  EXPECT_EQ(a.Rank(), size - 10);
+  Matrix null = a.Transpose().operator Matrix().NullSpace(1e-9);
+  EXPECT_EQ(null.getCols(), 10);
+  EXPECT_NEAR((a.Transpose() * null).Reduce(Reduction::NormInf), 0, 1e-9);
+}
+TEST(MatrixTest, CopyOnWrite) {
+  double ar[]{1, 2, 3, 4, 5, 6};
+  // Larger than INLINE_ELEMENTS, so the storage is on the heap.
+  Matrix a(5, 3, 6, ar);
+  Matrix b(a), c;
+  c = b;
+  EXPECT_EQ(b.getData(), a.getData());
+  EXPECT_EQ(c.getData(), a.getData());
+  b.setElement(0, 0, 10);
+  EXPECT_EQ(b.getData() == a.getData(), false);
+  EXPECT_EQ(c.getData(), a.getData());
+  EXPECT_EQ(a(0, 0), 1);
+  EXPECT_EQ(b(0, 0), 10);
+  c(1, 2) = 60;
+  EXPECT_EQ(a(1, 2), 6);
+  EXPECT_EQ(c(1, 2), 60);
+  // The last owner writes in place.
+  const double* data = c.getData();
+  c(0, 1) = 20;
+  EXPECT_EQ(c.getData(), data);
+
+  Matrix d(a), e(a), f(a), g(a);
+  d[1][1] = 50;
+  e.MapInPlace([](double x) { return -x; });
+  f.setDimentions(2, 2);
+  std::fill(g.begin(), g.end(), 0);
+  EXPECT_EQ(d(1, 1), 50);
+  EXPECT_EQ(e(1, 1), -5);
+  EXPECT_EQ(f.getCols(), 2);
+  EXPECT_EQ(g.Sum(), 0);
+  EXPECT_EQ(a.Sum(), 21);
+  EXPECT_EQ(a.getCols(), 3);
+  EXPECT_EQ(a.Rank(), 2);
+  EXPECT_EQ(a(1, 0), 4);
+
+  Matrix h(a);
+  h = h;
+  h = a;
+  a = Matrix();
+  EXPECT_EQ(h(1, 2), 6);
+  EXPECT_EQ(a.getData() == nullptr, true);
+}
+TEST(MatrixTest, CopyOnWrite_Threads) {
+  Matrix origin(64, 64);
+  std::iota(origin.begin(), origin.end(), 0);
+  const double sum = origin.Sum();
+  std::vector<std::thread> threads;
+  std::vector<double> sums(8);
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&origin, &sums, t] {
+      for (int k = 0; k < 50; k++) {
+        Matrix copy(origin), other(copy);
+        other = copy;
+        if (k % 2) copy(t, k) = -1;
+        sums[t] = copy.Sum();
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (int t = 0; t < 8; t++)
+    EXPECT_EQ(sums[t], sum - 1 - (t * 64 + 49));
+  EXPECT_EQ(origin.Sum(), sum);
+}
+TEST(MatrixTest, InlineStorage) {
+  auto stored_inline = [](const Matrix& m) {
+    const char* data = reinterpret_cast<const char*>(m.getData());
+    return data >= reinterpret_cast<const char*>(&m) &&
+           data < reinterpret_cast<const char*>(&m + 1);
+  };
+  double ar[]{1, 2, 3, 4, 5, 6, 7, 8, 9};
+  Matrix a(3, 3, 9, ar);
+  EXPECT_EQ(stored_inline(a), true);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.getData()) % MEMORY_ALIGNMENT,
+            0);
+  Matrix copy(a), moved(std::move(copy));
+  EXPECT_EQ(stored_inline(moved), true);
+  EXPECT_EQ(copy.getData() == nullptr, true);
+  moved(0, 0) = 10;
+  EXPECT_EQ(a(0, 0), 1);
+  EXPECT_EQ(moved(2, 2), 9);
+  EXPECT_EQ((a * a)(2, 2), 150);
+  EXPECT_EQ(a.Pow(3)(0, 0), 468);
+
+  // Growing moves the matrix to the heap, shrinking brings it back.
+  a.setDimentions(5, 5);
+  EXPECT_EQ(stored_inline(a), false);
+  EXPECT_EQ(a(2, 1), 8);
+  EXPECT_EQ(a(4, 4), 0);
+  Matrix heap(a);
+  EXPECT_EQ(heap.getData(), a.getData());
+  a.setDimentions(2, 2);
+  a.shrink_to_fit();
+  EXPECT_EQ(stored_inline(a), true);
+  EXPECT_EQ(a(1, 1), 5);
+  EXPECT_EQ(heap(1, 1), 5);
+  a = heap;
+  EXPECT_EQ(a.getData(), heap.getData());
+  a = moved;
+  EXPECT_EQ(stored_inline(a), true);
+  EXPECT_EQ(a(0, 0), 10);
+
+  std::vector<Matrix> many;
+  for (int k = 0; k < 20; k++) {
+    many.emplace_back(4, 4);
+    many.back()(3, 3) = k;
+  }
+  for (int k = 0; k < 20; k++) EXPECT_EQ(many[k](3, 3), k);
+  Matrix column;
+  for (int k = 0; k < 17; k++) {
+    const double value = k;
+    column.appendRow(1, &value);
+  }
+  EXPECT_EQ(stored_inline(column), false);
+  EXPECT_EQ(column(16, 0), 16);
+}
+TEST(MatrixTest, ExternalBuffers) {
+  // A 3 x 3 matrix in the first columns of a 3 x 5 buffer.
+  double buffer[15];
+  std::iota(buffer, buffer + 15, 0);
+  Matrix borrowed(buffer, 3, 3, 5);
+  EXPECT_EQ(borrowed.getData(), buffer);
+  EXPECT_EQ(borrowed(2, 1), 11);
+  borrowed(0, 0) = 100;
+  EXPECT_EQ(buffer[0], 100);
+  Matrix::ConstSpan view = static_cast<const Matrix&>(borrowed).span();
+  EXPECT_EQ(view.data(), buffer);
+  EXPECT_EQ(view.stride(), 5);
+  EXPECT_EQ(view(1, 2), 7);
+  EXPECT_EQ(view.row(2).size(), 3);
+  Matrix::Span span = borrowed.span();
+  span(2, 2) = -1;
+  EXPECT_EQ(buffer[12], -1);
+  EXPECT_EQ(borrowed.Determinant() != 0, true);
+  // Columns past the shape belong to the buffer owner.
+  borrowed.setDimentions(3, 4);
+  EXPECT_EQ(borrowed.getData() == buffer, false);
+  EXPECT_EQ(buffer[3], 3);
+  EXPECT_EQ(borrowed(0, 3), 0);
+  EXPECT_EQ(borrowed(1, 1), 6);
+
+  const double constant[]{1, 2, 3, 4};
+  Matrix read_only(constant, 2, 2, 2);
+  EXPECT_EQ(read_only.getData(), constant);
+  EXPECT_EQ(read_only.Determinant(), -2);
+  read_only(0, 0) = 5;
+  EXPECT_EQ(constant[0], 1);
+  EXPECT_EQ(read_only(0, 0), 5);
+  EXPECT_EQ(read_only(1, 1), 4);
+  // The copy of a view into a wide buffer does not take over its stride.
+  std::vector<double> wide(3 * 1000, 1);
+  Matrix column_view(static_cast<const double*>(wide.data()), 3, 2, 1000);
+  EXPECT_EQ(column_view.getColCapacity(), 2);
+  EXPECT_EQ(column_view.getStride(), 1000);
+  column_view(2, 1) = 4;
+  EXPECT_EQ(wide[2001], 1);
+  EXPECT_EQ(column_view.getStride(), MatrixService::paddedStride(2));
+  EXPECT_EQ(column_view.getRowCapacity(), 3);
+  EXPECT_EQ(column_view.Sum(), 9);
+
+  int deleted = 0;
+  double* owned = new double[6]{1, 2, 3, 4, 5, 6};
+  {
+    Matrix adopted(owned, 2, 3, 3, [&deleted](double* data) {
+      delete[] data;
+      deleted++;
+    });
+    Matrix copy(adopted), moved(std::move(adopted));
+    EXPECT_EQ(copy.getData(), owned);
+    EXPECT_EQ(moved.getData(), owned);
+    copy(1, 2) = 0;
+    EXPECT_EQ(owned[5], 6);
+    EXPECT_EQ(moved.Sum(), 21);
+    EXPECT_EQ(deleted, 0);
+  }
+  EXPECT_EQ(deleted, 1);
+
+  EXPECT_THROW(Matrix(buffer, 3, 3, 2), InputError);
+  EXPECT_THROW(Matrix(static_cast<double*>(nullptr), 3, 3, 3), InputError);
+  EXPECT_THROW(Matrix(buffer, 0, 3, 3), DimentionError);
+  EXPECT_EQ(Matrix().span().data() == nullptr, true);
+}
+TEST(MatrixTest, BlasBackend) {
+  const TuningConfig initial = MatrixTuning::get();
+  double buffer[7 * 8];
+  for (int i = 0; i < 7 * 8; i++) buffer[i] = (i * 7 % 11) - 5;
+  // A 7 x 5 matrix with a stride of 8 elements.
+  const Matrix a(buffer, 7, 5, 8);
+  Matrix b(5, 6), s(6, 6), singular(6, 6);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 5; j++) b(j, i) = (i * 3 + j * 5) % 13 - 6;
+    for (int j = 0; j < 6; j++) {
+      s(i, j) = (i + 2 * j) % 5 + (i == j ? 10 : 0);
+      singular(i, j) = i + j;
+    }
+  }
+  // The same operations with the built-in kernels and with the backend
+  // (identical when no backend is compiled in).
+  auto run = [&](const int order, double& det) {
+    TuningConfig config = initial;
+    config.blas_order = order;
+    MatrixTuning::set(config);
+    det = s.Determinant();
+    EXPECT_EQ(singular.Determinant(), 0);
+    EXPECT_THROW(singular.InverseMatrix(), NonInvertibleError);
+    return std::vector<Matrix>{a * b,
+                               a.Transpose() * a,
+                               b * b.Transpose(),
+                               b.Transpose() * a.Transpose(),
+                               s.InverseMatrix(),
+                               s.Solve(b.Transpose()),
+                               s.Pow(3)};
+  };
+  double native_det = 0, backend_det = 0;
+  const std::vector<Matrix> native = run(std::numeric_limits<int>::max(),
+                                         native_det),
+                            backend = run(1, backend_det);
+  EXPECT_NEAR(backend_det, native_det, 1e-9 * fabs(native_det));
+  for (size_t k = 0; k < native.size(); k++) {
+    EXPECT_EQ(native[k].getRows(), backend[k].getRows());
+    EXPECT_EQ(native[k].getCols(), backend[k].getCols());
+    EXPECT_LE((native[k] - backend[k]).Reduce(Reduction::NormInf),
+              1e-12 * std::max(1.0, native[k].Reduce(Reduction::NormInf)));
+  }
+  const Vector x = s.Solve(Vector(6, 6, buffer));
+  EXPECT_NEAR((s * x)[5], buffer[5], 1e-12);
+
+  const bool deterministic = MatrixParallel::isDeterministic();
+  MatrixParallel::setDeterministic(false);
+  EXPECT_EQ(MatrixBlas::accepts(1e6), MatrixBlas::available());
+  MatrixParallel::setDeterministic(true);
+  EXPECT_EQ(MatrixBlas::accepts(1e6), false);
+  MatrixParallel::setDeterministic(deterministic);
+  MatrixTuning::set(initial);
+}
+
 // elevator     end
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
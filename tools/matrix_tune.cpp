@@ -0,0 +1,135 @@
+/**
+ * @file matrix_tune.cpp
+ * @brief Benchmarks the kernel block sizes on the local host and writes the
+ * fastest ones to the configuration file loaded by the library.
+ * @details Usage: matrix_tune [file]; the file defaults to
+ * MatrixTuning::defaultPath(). Every parameter is tuned in turn, keeping the
+ * best values found for the previous ones.
+ */
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "../src/matrix_blas.hpp"
+#include "../src/matrix_cpp.hpp"
+#include "../src/matrix_tuning.hpp"
+#include "../src/matrix_vector.hpp"
+
+// Runs of every measurement, the fastest one is kept.
+static constexpr int TUNE_REPEATS = 3;
+
+/**
+ * @brief Creates a matrix filled with a deterministic pattern.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @return The matrix.
+ */
+static Matrix pattern(const int rows, const int cols) {
+  Matrix matrix(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++)
+      matrix.setElement(i, j, ((i * 7 + j * 13) % 17) * 0.125 - 1);
+  }
+  return matrix;
+}
+
+/**
+ * @brief Measures the fastest of several runs of an operation.
+ * @param operation The operation.
+ * @return Time in seconds.
+ */
+template <typename Operation>
+static double measure(Operation&& operation) {
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < TUNE_REPEATS; run++) {
+    const auto start = std::chrono::steady_clock::now();
+    operation();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+/**
+ * @brief Tries every candidate value of one parameter.
+ * @param name The name of the parameter.
+ * @param config The configuration; the parameter is set to the best value.
+ * @param field The parameter.
+ * @param candidates The values to try.
+ * @param operation The benchmark.
+ */
+template <typename T, typename Operation>
+static void tune(const char* name, TuningConfig& config, T TuningConfig::*field,
+                 const std::vector<T>& candidates, Operation&& operation) {
+  T best_value = config.*field;
+  double best_time = std::numeric_limits<double>::max();
+  for (const T value : candidates) {
+    TuningConfig candidate = config;
+    candidate.*field = value;
+    MatrixTuning::set(candidate);
+    const double time = measure(operation);
+    std::cout << name << " = " << value << ": " << time * 1e3 << " ms\n";
+    if (time < best_time) {
+      best_time = time;
+      best_value = value;
+    }
+  }
+  config.*field = best_value;
+  MatrixTuning::set(config);
+}
+
+int main(int argc, char* argv[]) {
+  const std::string path = argc > 1 ? argv[1] : MatrixTuning::defaultPath();
+  if (path.empty()) {
+    std::cerr << "No configuration file: pass a path or set HOME\n";
+    return 1;
+  }
+  std::cout << "Tuning for " << MatrixTuning::hostName() << "\n";
+  TuningConfig config;
+  // The native kernels are tuned first, with the backend out of the way.
+  const int blas_order = config.blas_order;
+  config.blas_order = std::numeric_limits<int>::max();
+  MatrixTuning::set(config);
+
+  const Matrix wide = pattern(2048, 2048);
+  tune("transpose_block", config, &TuningConfig::transpose_block,
+       {8, 16, 32, 64, 128}, [&]() { Matrix result(wide.Transpose()); });
+
+  const Matrix square = pattern(768, 768);
+  tune("multiply_block", config, &TuningConfig::multiply_block,
+       {32, 64, 128, 256, 512, 768},
+       [&]() { Matrix result(square * square); });
+
+  // Sizes around the point where splitting a loop starts to pay off.
+  std::vector<Matrix> small;
+  for (int size = 16; size <= 256; size *= 2)
+    small.push_back(pattern(size, size));
+  tune("parallel_grain", config, &TuningConfig::parallel_grain,
+       {1L << 12, 1L << 14, 1L << 16, 1L << 18, 1L << 20}, [&]() {
+         for (int run = 0; run < 20; run++) {
+           for (const Matrix& matrix : small) Matrix result(matrix * matrix);
+         }
+       });
+
+  config.blas_order = blas_order;
+  MatrixTuning::set(config);
+  if (MatrixBlas::available()) {
+    // Products on both sides of the sizes where the backend takes over.
+    std::vector<Matrix> sizes;
+    for (int size = 24; size <= 384; size *= 2)
+      sizes.push_back(pattern(size, size));
+    tune("blas_order", config, &TuningConfig::blas_order,
+         {16, 32, 64, 128, 256, 512}, [&]() {
+           for (const Matrix& matrix : sizes) Matrix result(matrix * matrix);
+         });
+  }
+
+  if (!MatrixTuning::save(path, config)) {
+    std::cerr << "Can not write " << path << "\n";
+    return 1;
+  }
+  std::cout << "Saved to " << path << "\n";
+  return 0;
+}